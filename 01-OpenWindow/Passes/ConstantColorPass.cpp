@@ -25,6 +25,9 @@ bool ConstantColorPass::initialize(RenderContext* pRenderContext, ResourceManage
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
 
+	// Let the pipeline know how data flows through this pass (we clear every pixel of the output)
+	declareChannelWrite(ResourceManager::kOutputChannel, true);
+
     return true;  // Successful initialization.
 }
 
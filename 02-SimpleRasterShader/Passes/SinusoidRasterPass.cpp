@@ -30,6 +30,9 @@ bool SinusoidRasterPass::initialize(RenderContext* pRenderContext, ResourceManag
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
 
+	// Let the pipeline know how data flows through this pass (our full-screen shader writes every pixel)
+	declareChannelWrite(ResourceManager::kOutputChannel, true);
+
     // We're rendering with the rasterizer, so we need to define our gfx pipeline state (we'll use the default)
     mpGfxState = GraphicsState::create();
 
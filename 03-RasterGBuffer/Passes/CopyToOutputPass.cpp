@@ -27,13 +27,37 @@ bool CopyToOutputPass::initialize(RenderContext* pRenderContext, ResourceManager
 
 	// Create a dropdown list to display in the GUI.  Start with no displayable output buffers. 
 	mDisplayableBuffers.push_back({ -1, "< None >" });
+	updateChannelDeclarations();
     return true;
 }
 
 void CopyToOutputPass::renderGui(Gui* pGui)
 {
 	// Add a widget to allow us to select our buffer to display
-	pGui->addDropdown("Displayed", mDisplayableBuffers, mSelectedBuffer);
+	if (pGui->addDropdown("Displayed", mDisplayableBuffers, mSelectedBuffer))
+	{
+		// Our input changed, so the set of passes the pipeline needs to run may have changed, too
+		updateChannelDeclarations();
+		setRebindFlag();
+	}
+}
+
+void CopyToOutputPass::updateChannelDeclarations()
+{
+	clearChannelDeclarations();
+	declareChannelWrite(ResourceManager::kOutputChannel);
+
+	// Only declare a read if we've selected a valid buffer to copy from
+	if (hasValidSelection())
+		declareChannelRead(mpResManager->getTextureName(int32_t(mSelectedBuffer)));
+}
+
+bool CopyToOutputPass::hasValidSelection() const
+{
+	if (!mpResManager || mSelectedBuffer >= mpResManager->getTextureCount()) return false;
+
+	// Copying the output onto itself isn't a valid selection, either
+	return int32_t(mSelectedBuffer) != mpResManager->getTextureIndex(ResourceManager::kOutputChannel);
 }
 
 void CopyToOutputPass::execute(RenderContext* pRenderContext)
@@ -43,10 +67,10 @@ void CopyToOutputPass::execute(RenderContext* pRenderContext)
 	if (!outTex) return;
 
 	// Grab our input buffer, as selected by the user from the GUI
-	Texture::SharedPtr inTex = mpResManager->getTexture( mSelectedBuffer );
+	Texture::SharedPtr inTex = hasValidSelection() ? mpResManager->getTexture( int32_t(mSelectedBuffer) ) : nullptr;
 
 	// If we have selected an invalid texture, clear our output to black and return.
-	if (!inTex || mSelectedBuffer == uint32_t(-1))
+	if (!inTex)
 	{
 		pRenderContext->clearRtv(outTex->getRTV().get(), vec4(0.0f,0.0f,0.0f, 1.0f));
 		return;
@@ -67,8 +91,9 @@ void CopyToOutputPass::pipelineUpdated(ResourceManager::SharedPtr pResManager)
 	if (!pResManager) return;
 	mpResManager = pResManager;
 
-	// Clear the GUI's list of displayable textures
+	// Clear the GUI's list of displayable textures.  If our old selection no longer exists, forget it.
 	mDisplayableBuffers.clear();
+	if (!hasValidSelection()) mSelectedBuffer = uint32_t(-1);
 
 	// We're not allowing the user to display the output buffer, so identify that resource
 	int32_t outputChannel = mpResManager->getTextureIndex(ResourceManager::kOutputChannel);
@@ -92,4 +117,7 @@ void CopyToOutputPass::pipelineUpdated(ResourceManager::SharedPtr pResManager)
 		mDisplayableBuffers.push_back({ -1, "< None >" });
 		mSelectedBuffer = uint32_t(-1);
 	}
+
+	// Our selection may have changed, so update what we tell the pipeline we read
+	updateChannelDeclarations();
 }
\ No newline at end of file
@@ -47,6 +47,13 @@ protected:
 
 	// Override some functions that provide information to the RenderPipeline class
 	bool appliesPostprocess() override { return true; }
+	bool isDisplayOnly() override { return true; }
+
+	// Tell the pipeline we write the output and read whichever buffer is currently selected
+	void updateChannelDeclarations();
+
+	// Is mSelectedBuffer a texture we can copy from?  (It's stale after a pipeline change, and -1 means "< None >")
+	bool hasValidSelection() const;
 
 	Gui::DropdownList mDisplayableBuffers;  
 	uint32_t          mSelectedBuffer = 0xFFFFFFFFu;
@@ -38,6 +38,14 @@ bool SimpleGBufferPass::initialize(RenderContext* pRenderContext, ResourceManage
 	// We also need a depth buffer to use when rendering our g-buffer.  Ask for one, with appropriate format and binding flags.
 	mpResManager->requestTextureResource("Z-Buffer", ResourceFormat::D24UnormS8, ResourceManager::kDepthBufferFlags);
 
+	// Let the pipeline know which channels we produce (so it can skip us if nobody needs them)
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse");
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+	declareChannelWrite("Z-Buffer");
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -40,6 +40,14 @@ bool RayTracedGBufferPass::initialize(RenderContext* pRenderContext, ResourceMan
 	mpResManager->requestTextureResources({ "WorldPosition", "WorldNormal", "MaterialDiffuse", 
 		                                    "MaterialSpecRough", "MaterialExtraParams", "Emissive" });
 
+	// Let the pipeline know which channels we produce.  Rays that miss leave these at their cleared values.
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse");
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+	declareChannelWrite("Emissive");
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -36,6 +36,7 @@ protected:
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void execute(RenderContext* pRenderContext) override;
 	void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+	void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
 
 	// The base RenderPass class defines a number of methods that we can override to 
 	//    specify what properties this pass has.  
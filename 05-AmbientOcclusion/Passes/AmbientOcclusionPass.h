@@ -36,6 +36,7 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void renderGui(Gui* pGui) override;
     void execute(RenderContext* pRenderContext) override;
 
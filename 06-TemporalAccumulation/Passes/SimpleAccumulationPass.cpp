@@ -41,6 +41,10 @@ bool SimpleAccumulationPass::initialize(RenderContext* pRenderContext, ResourceM
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(mAccumChannel);
 
+	// We accumulate in place:  we both read and overwrite this channel
+	declareChannelRead(mAccumChannel);
+	declareChannelWrite(mAccumChannel);
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -47,6 +47,7 @@ protected:
 
 	// The RenderPass class defines various methods we can override to specify this pass' properties. 
 	bool appliesPostprocess() override { return true; }
+	bool accumulatesSamples() override { return true; }
 
 	// A helper utility to determine if the current scene (if any) has had any camera motion
 	bool hasCameraMoved();
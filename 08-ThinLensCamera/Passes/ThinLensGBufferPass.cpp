@@ -41,6 +41,13 @@ bool ThinLensGBufferPass::initialize(RenderContext* pRenderContext, ResourceMana
 	mpResManager->requestTextureResources({ "WorldPosition", "WorldNormal", "MaterialDiffuse",
 		                                    "MaterialSpecRough", "MaterialExtraParams" });
 
+	// Let the pipeline know which channels we produce
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse", true);     // Hits write material colors, misses write the background
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -42,6 +42,7 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void execute(RenderContext* pRenderContext) override;
 
 	// The RenderPass class defines various methods we can override to specify this pass' properties. 
@@ -48,6 +48,14 @@ bool LightProbeGBufferPass::initialize(RenderContext* pRenderContext, ResourceMa
 	//     texture to load at startup by telling our resource manager where to find it. 
 	mpResManager->updateEnvironmentMap(kEnvironmentMap);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead(ResourceManager::kEnvironmentMap);
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse", true);     // Hits write material colors, misses write the background
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
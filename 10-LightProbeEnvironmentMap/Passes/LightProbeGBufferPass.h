@@ -45,6 +45,7 @@ protected:
     void execute(RenderContext* pRenderContext) override;
 	void renderGui(Gui* pGui) override;
 	void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+	void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
 
 	// The RenderPass class defines various methods we can override to specify this pass' properties. 
 	bool requiresScene() override  { return true; }
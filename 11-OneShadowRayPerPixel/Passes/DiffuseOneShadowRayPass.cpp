@@ -37,6 +37,12 @@ bool DiffuseOneShadowRayPass::initialize(RenderContext* pRenderContext, Resource
 	mpResManager->requestTextureResources({ "WorldPosition", "WorldNormal", "MaterialDiffuse" });
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead("WorldPosition");
+	declareChannelRead("WorldNormal");
+	declareChannelRead("MaterialDiffuse");
+	declareChannelWrite(ResourceManager::kOutputChannel, true);    // Our ray generation shader writes every pixel
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -58,11 +64,18 @@ void DiffuseOneShadowRayPass::initScene(RenderContext* pRenderContext, Scene::Sh
 
 void DiffuseOneShadowRayPass::execute(RenderContext* pRenderContext)
 {
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(ResourceManager::kOutputChannel);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
+
 	// Get the output buffer we're writing into; clear it to black.
 	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(ResourceManager::kOutputChannel, vec4(0.0f, 0.0f, 0.0f, 0.0f));
-
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	if (!pDstTex) return;
 
 	// Set our ray tracing shader variables 
 	auto rayGenVars = mpRays->getRayGenVars();
@@ -45,6 +45,7 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void execute(RenderContext* pRenderContext) override;
 
 	// Override some functions that provide information to the RenderPipeline class
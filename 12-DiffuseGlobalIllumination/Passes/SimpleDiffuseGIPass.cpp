@@ -43,6 +43,13 @@ bool SimpleDiffuseGIPass::initialize(RenderContext* pRenderContext, ResourceMana
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
 	mpResManager->requestTextureResource(ResourceManager::kEnvironmentMap);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead("WorldPosition");
+	declareChannelRead("WorldNormal");
+	declareChannelRead("MaterialDiffuse");
+	declareChannelRead(ResourceManager::kEnvironmentMap);
+	declareChannelWrite(ResourceManager::kOutputChannel, true);    // Our ray generation shader writes every pixel
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -84,11 +91,18 @@ void SimpleDiffuseGIPass::renderGui(Gui* pGui)
 
 void SimpleDiffuseGIPass::execute(RenderContext* pRenderContext)
 {
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(ResourceManager::kOutputChannel);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
+
 	// Get the output buffer we're writing into
 	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(ResourceManager::kOutputChannel, vec4(0.0f, 0.0f, 0.0f, 0.0f));
-
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	if (!pDstTex) return;
 
 	// Set our shader variables for the ray generation shader
 	auto rayGenVars = mpRays->getRayGenVars();
@@ -31,6 +31,10 @@ bool SimpleToneMappingPass::initialize(RenderContext* pRenderContext, ResourceMa
 	mpResManager = pResManager;
 	mpResManager->requestTextureResources({ mInChannel, mOutChannel });
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead(mInChannel);
+	declareChannelWrite(mOutChannel);
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
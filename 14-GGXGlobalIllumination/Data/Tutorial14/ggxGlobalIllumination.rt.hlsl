@@ -30,13 +30,27 @@ import Lights;                       // Light structures for our current scene
 shared cbuffer GlobalCB
 {
 	float gMinT;           // Min distance to start a ray to avoid self-occlusion
-	uint  gFrameCount;     // An integer changing every frame to update the random number
 	bool  gDoIndirectGI;   // A boolean determining if we should shoot indirect GI rays
 	bool  gDoDirectGI;     // A boolean determining if we should compute direct lighting
 	uint  gMaxDepth;       // Maximum number of recursive bounces to allow
     float gEmitMult;       // Multiply emissive amount by this factor (set to 1, usually)
 }
 
+// Kept apart from GlobalCB, which the C++ code only re-sends when a setting changes
+shared cbuffer PerFrameCB
+{
+	uint  gFrameCount;     // An integer changing every frame to update the random number
+}
+
+// The C++ code may compile our toggles into the shader (e.g., "#define DO_DIRECT_GI 0"), which removes their
+//    branches.  Otherwise, we branch on the values in GlobalCB.
+#ifndef DO_DIRECT_GI
+#define DO_DIRECT_GI    gDoDirectGI
+#endif
+#ifndef DO_INDIRECT_GI
+#define DO_INDIRECT_GI  gDoIndirectGI
+#endif
+
 // Input and out textures that need to be set by the C++ code (for the ray gen shader)
 shared Texture2D<float4>   gPos;
 shared Texture2D<float4>   gNorm;
@@ -116,12 +130,12 @@ void SimpleDiffuseGIRayGen()
         shadeColor = gEmitMult * pixelEmissive.rgb;
 
 		// (Optionally) do explicit direct lighting to a random light in the scene
-		if (gDoDirectGI)
+		if (DO_DIRECT_GI)
 			shadeColor += ggxDirect(randSeed, worldPos.xyz, worldNorm.xyz, V,
 				                   difMatlColor.rgb, specMatlColor.rgb, roughness);
 
 		// (Optionally) do indirect lighting for global illumination
-		if (gDoIndirectGI && (gMaxDepth > 0))
+		if (DO_INDIRECT_GI && (gMaxDepth > 0))
 			shadeColor += ggxIndirect(randSeed, worldPos.xyz, worldNorm.xyz, noMapN,
 				                      V, difMatlColor.rgb, specMatlColor.rgb, roughness, 0);
 	}
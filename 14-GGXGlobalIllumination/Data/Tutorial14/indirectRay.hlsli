@@ -204,7 +204,7 @@ void IndirectClosestHit(inout IndirectRayPayload rayData, BuiltInTriangleInterse
     rayData.color = gEmitMult * shadeData.emissive.rgb;
 
 	// Do direct illumination at this hit location
-    if (gDoDirectGI)
+    if (DO_DIRECT_GI)
     {
         rayData.color += ggxDirect(rayData.rndSeed, shadeData.posW, shadeData.N, shadeData.V,
             shadeData.diffuse, shadeData.specular, shadeData.roughness);
@@ -33,6 +33,14 @@ namespace {
 	const char* kEntryPointMiss1         = "IndirectMiss";
 	const char* kEntryIndirectAnyHit     = "IndirectAnyHit";
 	const char* kEntryIndirectClosestHit = "IndirectClosestHit";
+
+	// Channels we access every frame (hashed at compile time, so lookups don't build or compare strings)
+	constexpr ChannelId kWorldPositionChannel("WorldPosition");
+	constexpr ChannelId kWorldNormalChannel("WorldNormal");
+	constexpr ChannelId kMaterialDiffuseChannel("MaterialDiffuse");
+	constexpr ChannelId kMaterialSpecRoughChannel("MaterialSpecRough");
+	constexpr ChannelId kMaterialExtraParamsChannel("MaterialExtraParams");
+	constexpr ChannelId kEmissiveChannel("Emissive");
 };
 
 bool GGXGlobalIlluminationPass::initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager)
@@ -43,6 +51,12 @@ bool GGXGlobalIlluminationPass::initialize(RenderContext* pRenderContext, Resour
 	mpResManager->requestTextureResource(mOutputTextureName);
 	mpResManager->requestTextureResource(ResourceManager::kEnvironmentMap);
 
+	// Let the pipeline know how data flows through this pass
+	for (auto channel : { "WorldPosition", "WorldNormal", "MaterialDiffuse", "MaterialSpecRough", "MaterialExtraParams", "Emissive" })
+		declareChannelRead(channel);
+	declareChannelRead(ResourceManager::kEnvironmentMap);
+	declareChannelWrite(mOutputTextureName, true);    // Our ray generation shader writes every pixel
+
 	// Set the default scene to load
 	mpResManager->setDefaultSceneName("Data/pink_room/pink_room.fscene");
 
@@ -58,6 +72,7 @@ bool GGXGlobalIlluminationPass::initialize(RenderContext* pRenderContext, Resour
 	mpRays->addHitShader(kFileRayTrace, kEntryIndirectClosestHit, kEntryIndirectAnyHit);
 
 	// Now that we've passed all our shaders in, compile and (if available) setup the scene
+	updateShaderVariant();
 	mpRays->compileRayProgram();
 	mpRays->setMaxRecursionDepth(uint32_t(mMaxPossibleRayDepth));
 	if (mpScene) mpRays->setScene(mpScene);
@@ -79,34 +94,67 @@ void GGXGlobalIlluminationPass::renderGui(Gui* pGui)
 		                            mDoDirectGI);
 	dirty |= (int)pGui->addCheckBox(mDoIndirectGI ? "Shooting global illumination rays" : "Skipping global illumination", 
 		                            mDoIndirectGI);
-	if (dirty) setRefreshFlag();
+	dirty |= (int)pGui->addCheckBox("Compile toggles into shader variants", mSpecializeToggles);
+	if (dirty)
+	{
+		updateShaderVariant();
+		setRefreshFlag();
+	}
+}
+
+void GGXGlobalIlluminationPass::updateShaderVariant()
+{
+	if (!mpRays) return;
+
+	// Specialized variants drop the disabled code entirely; otherwise the shader branches on gDoDirectGI and gDoIndirectGI
+	if (mSpecializeToggles)
+		mpRays->setDefines({ { "DO_DIRECT_GI", mDoDirectGI ? "1" : "0" }, { "DO_INDIRECT_GI", mDoIndirectGI ? "1" : "0" } });
+	else
+		mpRays->setDefines({}, { "DO_DIRECT_GI", "DO_INDIRECT_GI" });
 }
 
 
 void GGXGlobalIlluminationPass::execute(RenderContext* pRenderContext)
 {
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(mOutputTextureName);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
+
 	// Get the output buffer we're writing into
 	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(mOutputTextureName, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+	if (!pDstTex) return;
 
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	// Did a different program variant just take over?  Then frames accumulated so far came from the old one
+	if (mpRays->getProgramGeneration() != mProgramGeneration)
+	{
+		mProgramGeneration = mpRays->getProgramGeneration();
+		setRefreshFlag();
+	}
 
-	// Set our variables into the global HLSL namespace
+	// Set our variables into the global HLSL namespace.  (A layout mismatch is logged by upload(), which then
+	//    sets the fields individually, so we render either way.)
 	auto globalVars = mpRays->getGlobalVars();
-	globalVars["GlobalCB"]["gMinT"]         = mpResManager->getMinTDist();
-	globalVars["GlobalCB"]["gFrameCount"]   = mFrameCount++;
-	globalVars["GlobalCB"]["gDoIndirectGI"] = mDoIndirectGI;
-	globalVars["GlobalCB"]["gDoDirectGI"]   = mDoDirectGI;
-	globalVars["GlobalCB"]["gMaxDepth"]     = mUserSpecifiedRayDepth;
-    globalVars["GlobalCB"]["gEmitMult"]     = 1.0f;
-	globalVars["gPos"]         = mpResManager->getTexture("WorldPosition");
-	globalVars["gNorm"]        = mpResManager->getTexture("WorldNormal");
-	globalVars["gDiffuseMatl"] = mpResManager->getTexture("MaterialDiffuse");
-	globalVars["gSpecMatl"]    = mpResManager->getTexture("MaterialSpecRough");
-	globalVars["gExtraMatl"]   = mpResManager->getTexture("MaterialExtraParams");
-    globalVars["gEmissive"]    = mpResManager->getTexture("Emissive");
-	globalVars["gOutput"]      = pDstTex;
-	globalVars["gEnvMap"] = mpResManager->getTexture(ResourceManager::kEnvironmentMap);
+	mGlobalCB->gMinT         = mpResManager->getMinTDist();
+	mGlobalCB->gDoIndirectGI = mDoIndirectGI ? 1u : 0u;
+	mGlobalCB->gDoDirectGI   = mDoDirectGI ? 1u : 0u;
+	mGlobalCB->gMaxDepth     = uint32_t(mUserSpecifiedRayDepth);
+	mGlobalCB->gEmitMult     = 1.0f;
+	mGlobalCB.upload(globalVars);
+	globalVars[mBindFrameCount]   = mFrameCount++;
+
+	globalVars[mBindPos]          = mpResManager->getTexture(kWorldPositionChannel);
+	globalVars[mBindNorm]         = mpResManager->getTexture(kWorldNormalChannel);
+	globalVars[mBindDiffuseMatl]  = mpResManager->getTexture(kMaterialDiffuseChannel);
+	globalVars[mBindSpecMatl]     = mpResManager->getTexture(kMaterialSpecRoughChannel);
+	globalVars[mBindExtraMatl]    = mpResManager->getTexture(kMaterialExtraParamsChannel);
+    globalVars[mBindEmissive]     = mpResManager->getTexture(kEmissiveChannel);
+	globalVars[mBindOutput]       = pDstTex;
+	globalVars[mBindEnvMap]       = mpResManager->getTexture(ResourceManager::kEnvironmentMapId);
 
 	// Shoot our rays and shade our primary hit points
 	mpRays->execute( pRenderContext, mpResManager->getScreenSize() );
@@ -23,6 +23,7 @@
 #pragma once
 #include "../SharedUtils/RenderPass.h"
 #include "../SharedUtils/RayLaunch.h"
+#include "../SharedUtils/ConstantBufferStruct.h"
 
 class GGXGlobalIlluminationPass : public ::RenderPass, inherit_shared_from_this<::RenderPass, GGXGlobalIlluminationPass>
 {
@@ -40,9 +41,13 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void execute(RenderContext* pRenderContext) override;
 	void renderGui(Gui* pGui) override;
 
+	// Pass our toggles to the shader as #defines (or not), which picks which program variant we render with
+	void updateShaderVariant();
+
 	// Override some functions that provide information to the RenderPipeline class
 	bool requiresScene() override { return true; }
 	bool usesRayTracing() override { return true; }
@@ -54,6 +59,8 @@ protected:
 	// Recursive ray tracing can be slow.  Add a toggle to disable, to allow you to manipulate the scene
 	bool                    mDoIndirectGI = true;
 	bool                    mDoDirectGI = true;
+	bool                    mSpecializeToggles = false;   ///< Compile the toggles into the shader, rather than branching on them
+	uint64_t                mProgramGeneration = 0;       ///< mpRays->getProgramGeneration() when we last rendered
 
 	int32_t                 mUserSpecifiedRayDepth = 1;   ///<  What is the current maximum ray depth
 	const int32_t           mMaxPossibleRayDepth = 8;     ///<  The largest ray depth we support (without recompile)
@@ -64,4 +71,34 @@ protected:
     
 	// Various internal parameters
 	uint32_t                mFrameCount = 0x1337u;        ///< A frame counter to vary random numbers over time
+
+	// Mirrors the "GlobalCB" cbuffer in ggxGlobalIllumination.rt.hlsl, so it can be uploaded in one go (and only when
+	//    a setting changes; the frame count lives in its own cbuffer)
+	struct GlobalCB
+	{
+		float    gMinT;
+		uint32_t gDoIndirectGI;         ///< HLSL bools are 4 bytes
+		uint32_t gDoDirectGI;
+		uint32_t gMaxDepth;
+		float    gEmitMult;
+		uint32_t pad[3];                ///< HLSL pads cbuffers to 16 bytes
+
+		static std::vector<CBufferField> getLayout()
+		{
+			return { CBUFFER_FIELD(GlobalCB, gMinT),     CBUFFER_FIELD(GlobalCB, gDoIndirectGI), CBUFFER_FIELD(GlobalCB, gDoDirectGI),
+			         CBUFFER_FIELD(GlobalCB, gMaxDepth), CBUFFER_FIELD(GlobalCB, gEmitMult) };
+		}
+	};
+	ConstantBufferStruct<GlobalCB> mGlobalCB { "GlobalCB" };
+
+	// Variables and resources our ray tracing shaders read each frame
+	SimpleVars::Binding     mBindFrameCount   { "PerFrameCB", "gFrameCount" };
+	SimpleVars::Binding     mBindPos          { "gPos" };
+	SimpleVars::Binding     mBindNorm         { "gNorm" };
+	SimpleVars::Binding     mBindDiffuseMatl  { "gDiffuseMatl" };
+	SimpleVars::Binding     mBindSpecMatl     { "gSpecMatl" };
+	SimpleVars::Binding     mBindExtraMatl    { "gExtraMatl" };
+	SimpleVars::Binding     mBindEmissive     { "gEmissive" };
+	SimpleVars::Binding     mBindOutput       { "gOutput" };
+	SimpleVars::Binding     mBindEnvMap       { "gEnvMap" };
 };
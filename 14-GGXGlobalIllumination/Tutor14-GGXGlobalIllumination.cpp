@@ -41,6 +41,14 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 	config.windowDesc.width = 1920; 
 	config.windowDesc.height = 1080;
 
-	// Start our program!
-	RenderingPipeline::run(pipeline, config);
+	// Running with "--offline <image> [--scene <file>] [--frames <n>] [--spp <n>] ..." writes images to disk, then exits.
+	//    Otherwise, start our program interactively!
+	OfflineRenderSettings offlineSettings;
+	std::string argError;
+	if (parseOfflineCommandLine(lpCmdLine, offlineSettings, argError))
+		RenderingPipeline::runOffline(pipeline, config, offlineSettings);
+	else if (!argError.empty())
+		logError("Tutorial 14:  " + argError);
+	else
+		RenderingPipeline::run(pipeline, config);
 }
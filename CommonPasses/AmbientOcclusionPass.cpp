@@ -39,6 +39,11 @@ bool AmbientOcclusionPass::initialize(RenderContext* pRenderContext, ResourceMan
 	mNormalIndex   = mpResManager->requestTextureResource("WorldNormal");
 	mOutputIndex   = mpResManager->requestTextureResource(mOutputTexName);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead("WorldPosition");
+	declareChannelRead("WorldNormal");
+	declareChannelWrite(mOutputTexName, true);       // Our ray generation shader writes every pixel
+
 	// Create our wrapper around a ray tracing pass.  Tell it where our ray generation shader and ray-specific shaders are
 	mpRays = RayLaunch::create(kFileRayTrace, kEntryPointRayGen);
 	mpRays->addMissShader(kFileRayTrace, kEntryPointMiss0);
@@ -75,21 +80,28 @@ void AmbientOcclusionPass::renderGui(Gui* pGui)
 
 void AmbientOcclusionPass::execute(RenderContext* pRenderContext)
 {
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(mOutputIndex);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
+
 	// Get our output buffer; clear it to black.
 	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(mOutputIndex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
-
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	if (!pDstTex) return;
 
 	// Set our ray tracing shader variables (just for the ray gen shader here)
 	auto rayGenVars = mpRays->getRayGenVars();
-	rayGenVars["RayGenCB"]["gFrameCount"]  = mFrameCount++;
-	rayGenVars["RayGenCB"]["gAORadius"]    = mAORadius;
-	rayGenVars["RayGenCB"]["gMinT"]        = mpResManager->getMinTDist();  // From the UI dropdown
-	rayGenVars["RayGenCB"]["gNumRays"]     = uint32_t(mNumRaysPerPixel);
-	rayGenVars["gPos"]    = mpResManager->getTexture(mPositionIndex);
-	rayGenVars["gNorm"]   = mpResManager->getTexture(mNormalIndex);
-	rayGenVars["gOutput"] = pDstTex;
+	rayGenVars[mBindFrameCount] = mFrameCount++;
+	rayGenVars[mBindAORadius]   = mAORadius;
+	rayGenVars[mBindMinT]       = mpResManager->getMinTDist();  // From the UI dropdown
+	rayGenVars[mBindNumRays]    = uint32_t(mNumRaysPerPixel);
+	rayGenVars[mBindPos]        = mpResManager->getTexture(mPositionIndex);
+	rayGenVars[mBindNorm]       = mpResManager->getTexture(mNormalIndex);
+	rayGenVars[mBindOutput]     = pDstTex;
 
 	// Shoot our AO rays
 	mpRays->execute( pRenderContext, uvec2(pDstTex->getWidth(), pDstTex->getHeight()) );
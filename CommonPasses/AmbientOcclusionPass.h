@@ -38,6 +38,7 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void renderGui(Gui* pGui) override;
     void execute(RenderContext* pRenderContext) override;
 
@@ -54,6 +55,15 @@ protected:
 	uint32_t                                mFrameCount = 0;        ///< Frame count used to help seed our shaders' random number generator
 	int32_t                                 mNumRaysPerPixel = 1;   ///< How many ambient occlusion rays should we shot per pixel?
 
+	// Constants and textures our AO rays need each frame
+	SimpleVars::Binding                     mBindFrameCount { "RayGenCB", "gFrameCount" };
+	SimpleVars::Binding                     mBindAORadius   { "RayGenCB", "gAORadius" };
+	SimpleVars::Binding                     mBindMinT       { "RayGenCB", "gMinT" };
+	SimpleVars::Binding                     mBindNumRays    { "RayGenCB", "gNumRays" };
+	SimpleVars::Binding                     mBindPos        { "gPos" };
+	SimpleVars::Binding                     mBindNorm       { "gNorm" };
+	SimpleVars::Binding                     mBindOutput     { "gOutput" };
+
 	// Indices we can use to query the resource manager for various texture resources
 	int32_t                                 mPositionIndex;         ///< An index for the G-Buffer wsPosition buffer
 	int32_t                                 mNormalIndex;           ///< An index for the G-Buffer wsNormal buffer
@@ -30,6 +30,7 @@ bool CopyToOutputPass::initialize(RenderContext* pRenderContext, ResourceManager
 
 	// When we start, let's assume there are no valid buffers to copy from; create a GUI list that says so
 	mDisplayableBuffers.push_back({ -1, "< None >" });
+	updateChannelDeclarations();
 
 	// We have now finished initializing our pass
     return true;
@@ -38,22 +39,45 @@ bool CopyToOutputPass::initialize(RenderContext* pRenderContext, ResourceManager
 void CopyToOutputPass::renderGui(Gui* pGui)
 {
 	// Add a widget to allow us to select our buffer to display
-	pGui->addDropdown("Displayed", mDisplayableBuffers, mSelectedBuffer);
+	if (pGui->addDropdown("Displayed", mDisplayableBuffers, mSelectedBuffer))
+	{
+		// Our input changed, so the set of passes the pipeline needs to run may have changed, too
+		updateChannelDeclarations();
+		setRebindFlag();
+	}
+}
+
+void CopyToOutputPass::updateChannelDeclarations()
+{
+	clearChannelDeclarations();
+	declareChannelWrite(ResourceManager::kOutputChannel);
+
+	// Only declare a read if we've selected a valid buffer to copy from
+	if (hasValidSelection())
+		declareChannelRead(mpResManager->getTextureName(int32_t(mSelectedBuffer)));
+}
+
+bool CopyToOutputPass::hasValidSelection() const
+{
+	if (!mpResManager || mSelectedBuffer >= mpResManager->getTextureCount()) return false;
+
+	// Copying the output onto itself isn't a valid selection, either
+	return int32_t(mSelectedBuffer) != mpResManager->getTextureIndex(ResourceManager::kOutputChannelId);
 }
 
 void CopyToOutputPass::execute(RenderContext* pRenderContext)
 {
 	// Get a pointer to a Falcor texture resource for our output 
-	Texture::SharedPtr outTex = mpResManager->getTexture(ResourceManager::kOutputChannel);
+	Texture::SharedPtr outTex = mpResManager->getTexture(ResourceManager::kOutputChannelId);
 
 	// Our output texture doesn't exist?  We can't do much.
 	if (!outTex) return;
 
 	// Grab our input buffer, as selected by the user from the GUI
-	Texture::SharedPtr inTex = mpResManager->getTexture( mSelectedBuffer );
+	Texture::SharedPtr inTex = hasValidSelection() ? mpResManager->getTexture( int32_t(mSelectedBuffer) ) : nullptr;
 
 	// If we have selected an invalid texture, clear our output to black and return.
-	if (!inTex || mSelectedBuffer == uint32_t(-1))
+	if (!inTex)
 	{
 		pRenderContext->clearRtv(outTex->getRTV().get(), vec4(0.0f,0.0f,0.0f, 1.0f));
 		return;
@@ -74,8 +98,9 @@ void CopyToOutputPass::pipelineUpdated(ResourceManager::SharedPtr pResManager)
 	if (!pResManager) return;
 	mpResManager = pResManager;
 
-	// Clear the GUI's list of displayable textures
+	// Clear the GUI's list of displayable textures.  If our old selection no longer exists, forget it.
 	mDisplayableBuffers.clear();
+	if (!hasValidSelection()) mSelectedBuffer = uint32_t(-1);
 
 	// We're not allowing the user to display the output buffer, so identify that resource
 	int32_t outputChannel = mpResManager->getTextureIndex(ResourceManager::kOutputChannel);
@@ -99,4 +124,7 @@ void CopyToOutputPass::pipelineUpdated(ResourceManager::SharedPtr pResManager)
 		mDisplayableBuffers.push_back({ -1, "< None >" });
 		mSelectedBuffer = uint32_t(-1);
 	}
+
+	// Our selection may have changed, so update what we tell the pipeline we read
+	updateChannelDeclarations();
 }
\ No newline at end of file
@@ -21,8 +21,8 @@ cbuffer PerFrameCB
     uint gAccumCount;
 }
 
-Texture2D<float4>   gLastFrame;
-Texture2D<float4>   gCurFrame;
+Texture2D<float4>   gLastFrame;   // Accumulated result from last frame
+RWTexture2D<float4> gCurFrame;    // This frame's samples on input; overwritten with the new accumulated result
 
 float4 main(float2 texC : TEXCOORD, float4 pos : SV_Position) : SV_Target0
 {
@@ -30,5 +30,10 @@ float4 main(float2 texC : TEXCOORD, float4 pos : SV_Position) : SV_Target0
     float4 curColor = gCurFrame[pixelPos];
     float4 prevColor = gLastFrame[pixelPos];
 
-	return (gAccumCount * prevColor + curColor) / (gAccumCount + 1);
+	float4 accumColor = (gAccumCount * prevColor + curColor) / (gAccumCount + 1);
+
+	// Each pixel only touches its own texel, so reading and writing gCurFrame in place is safe.  Our render target
+	//    is next frame's gLastFrame.
+	gCurFrame[pixelPos] = accumColor;
+	return accumColor;
 }
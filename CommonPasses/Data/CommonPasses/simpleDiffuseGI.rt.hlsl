@@ -39,8 +39,21 @@ cbuffer RayGenCB
 	uint  gFrameCount;     // An integer changing every frame to update the random number
 	bool  gDoIndirectGI;   // A boolean determining if we should shoot indirect GI rays
 	bool  gCosSampling;    // Use cosine sampling (true) or uniform sampling (false)
+	bool  gDirectShadow;   // Should we shoot shadow rays from our first hit point?
 }
 
+// The C++ code may compile our toggles into the shader (e.g., "#define DO_INDIRECT_GI 0"), which removes their
+//    branches.  Otherwise, we branch on the values in RayGenCB.
+#ifndef DO_INDIRECT_GI
+#define DO_INDIRECT_GI     gDoIndirectGI
+#endif
+#ifndef COS_SAMPLING
+#define COS_SAMPLING       gCosSampling
+#endif
+#ifndef DO_DIRECT_SHADOWS
+#define DO_DIRECT_SHADOWS  gDirectShadow
+#endif
+
 // Input and out textures that need to be set by the C++ code (for the ray gen shader)
 Texture2D<float4> gPos;
 Texture2D<float4> gNorm;
@@ -164,17 +177,19 @@ void SimpleDiffuseGIRayGen()
 		float LdotN = saturate(dot(worldNorm.xyz, toLight));
 
 		// Shoot our ray for our direct lighting
-		float shadowMult = float(gLightsCount) * shadowRayVisibility(worldPos.xyz, toLight, gMinT, distToLight);
+		float shadowMult = float(gLightsCount);
+		if (DO_DIRECT_SHADOWS)
+			shadowMult *= shadowRayVisibility(worldPos.xyz, toLight, gMinT, distToLight);
 
 		// Compute our Lambertian shading color using the physically based Lambertian term (albedo / pi)
 		shadeColor = shadowMult * LdotN * lightIntensity * difMatlColor.rgb / M_PI;
 
 		// Now do our indirect illumination
-		if (gDoIndirectGI)
+		if (DO_INDIRECT_GI)
 		{
 			// Select a random direction for our diffuse interreflection ray.
 			float3 bounceDir;
-			if (gCosSampling)
+			if (COS_SAMPLING)
 				bounceDir = getCosHemisphereSample(randSeed, worldNorm.xyz);      // Use cosine sampling
 			else
 				bounceDir = getUniformHemisphereSample(randSeed, worldNorm.xyz);  // Use uniform random samples
@@ -186,7 +201,7 @@ void SimpleDiffuseGIRayGen()
 			float3 bounceColor = shootIndirectRay(worldPos.xyz, bounceDir, gMinT, randSeed);
 
 			// Probability of selecting this ray ( cos/pi for cosine sampling, 1/2pi for uniform sampling )
-			float sampleProb = gCosSampling ? (NdotL / M_PI) : (1.0f / (2.0f * M_PI));
+			float sampleProb = COS_SAMPLING ? (NdotL / M_PI) : (1.0f / (2.0f * M_PI));
 
 			// Accumulate the color.  For performance, terms could (and should) be cancelled here.
 			shadeColor += (NdotL * bounceColor * difMatlColor.rgb / M_PI) / sampleProb;
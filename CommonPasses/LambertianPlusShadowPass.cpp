@@ -27,6 +27,12 @@ namespace {
 	const char* kEntryPointMiss0   = "ShadowMiss";
 	const char* kEntryAoAnyHit     = "ShadowAnyHit";
 	const char* kEntryAoClosestHit = "ShadowClosestHit";
+
+	// Channels we access every frame (hashed at compile time, so lookups don't build or compare strings)
+	constexpr ChannelId kWorldPositionChannel("WorldPosition");
+	constexpr ChannelId kWorldNormalChannel("WorldNormal");
+	constexpr ChannelId kMaterialDiffuseChannel("MaterialDiffuse");
+	constexpr ChannelId kMaterialSpecRoughChannel("MaterialSpecRough");
 };
 
 bool LambertianPlusShadowPass::initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager)
@@ -41,6 +47,13 @@ bool LambertianPlusShadowPass::initialize(RenderContext* pRenderContext, Resourc
 	mpResManager->requestTextureResource("MaterialSpecRough");
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead("WorldPosition");
+	declareChannelRead("WorldNormal");
+	declareChannelRead("MaterialDiffuse");
+	declareChannelRead("MaterialSpecRough");
+	declareChannelWrite(ResourceManager::kOutputChannel, true);    // Our ray generation shader writes every pixel
+
 	// Create our wrapper around a ray tracing pass.  Tell it where our ray generation shader and ray-specific shaders are
 	mpRays = RayLaunch::create(kFileRayTrace, kEntryPointRayGen);
 	mpRays->addMissShader(kFileRayTrace, kEntryPointMiss0);
@@ -63,20 +76,27 @@ void LambertianPlusShadowPass::initScene(RenderContext* pRenderContext, Scene::S
 
 void LambertianPlusShadowPass::execute(RenderContext* pRenderContext)
 {
-	// Get the output buffer we're writing into
-	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(ResourceManager::kOutputChannel, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(ResourceManager::kOutputChannelId);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
 
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	// Get the output buffer we're writing into
+	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(ResourceManager::kOutputChannelId, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+	if (!pDstTex) return;
 
 	// Set our ray tracing shader variables 
 	auto rayGenVars = mpRays->getRayGenVars();
-	rayGenVars["RayGenCB"]["gMinT"] = mpResManager->getMinTDist();
-	rayGenVars["gPos"]         = mpResManager->getTexture("WorldPosition");
-	rayGenVars["gNorm"]        = mpResManager->getTexture("WorldNormal");
-	rayGenVars["gDiffuseMatl"] = mpResManager->getTexture("MaterialDiffuse");
-	rayGenVars["gSpecMatl"]    = mpResManager->getTexture("MaterialSpecRough");
-	rayGenVars["gOutput"]      = pDstTex;
+	rayGenVars[mBindMinT]        = mpResManager->getMinTDist();
+	rayGenVars[mBindPos]         = mpResManager->getTexture(kWorldPositionChannel);
+	rayGenVars[mBindNorm]        = mpResManager->getTexture(kWorldNormalChannel);
+	rayGenVars[mBindDiffuseMatl] = mpResManager->getTexture(kMaterialDiffuseChannel);
+	rayGenVars[mBindSpecMatl]    = mpResManager->getTexture(kMaterialSpecRoughChannel);
+	rayGenVars[mBindOutput]      = pDstTex;
 
 	// Shoot our rays and shade our primary hit points
 	mpRays->execute( pRenderContext, uvec2(pDstTex->getWidth(), pDstTex->getHeight()) );
@@ -38,6 +38,7 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void execute(RenderContext* pRenderContext) override;
 
 	// Override some functions that provide information to the RenderPipeline class
@@ -50,4 +51,12 @@ protected:
     
 	// Various internal parameters
 	uint32_t                                mMinTSelector = 1;      ///< Allow user to select which minT value to use for rays
+
+	// G-buffer inputs, output, and constants our ray generation shader reads each frame
+	SimpleVars::Binding                     mBindMinT        { "RayGenCB", "gMinT" };
+	SimpleVars::Binding                     mBindPos         { "gPos" };
+	SimpleVars::Binding                     mBindNorm        { "gNorm" };
+	SimpleVars::Binding                     mBindDiffuseMatl { "gDiffuseMatl" };
+	SimpleVars::Binding                     mBindSpecMatl    { "gSpecMatl" };
+	SimpleVars::Binding                     mBindOutput      { "gOutput" };
 };
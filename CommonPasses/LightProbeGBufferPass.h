@@ -39,6 +39,7 @@ protected:
     void execute(RenderContext* pRenderContext) override;
 	void renderGui(Gui* pGui) override;
 	void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+	void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
 
 	// Override some functions that provide information to the RenderPipeline class
 	bool requiresScene() override      { return true; }
@@ -36,6 +36,14 @@ bool SimpleAccumulationPass::initialize(RenderContext* pRenderContext, ResourceM
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(mAccumChannel);
 
+	// Our running average lives in a double-buffered history:  each frame we read last frame's average and write a new one
+	mHistoryIndex = mpResManager->requestHistoryResource(mAccumChannel + "::Accumulation");
+	if (mHistoryIndex < 0) return false;
+
+	// We accumulate in place:  we both read and overwrite this channel
+	declareChannelRead(mAccumChannel);
+	declareChannelWrite(mAccumChannel);
+
 	// Create our graphics state and accumulation shader
 	mpGfxState = GraphicsState::create();
 	mpAccumShader = FullscreenLaunch::create(kAccumShader);
@@ -61,14 +69,7 @@ void SimpleAccumulationPass::initScene(RenderContext* pRenderContext, Scene::Sha
 
 void SimpleAccumulationPass::resize(uint32_t width, uint32_t height)
 {
-    // Resize internal resources
-    mpLastFrame = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess | Resource::BindFlags::RenderTarget);
-
-    // We need a framebuffer to attach to our graphics pipe state (when running our full-screen pass)
-	mpInternalFbo = ResourceManager::createFbo(width, height, ResourceFormat::RGBA32Float);
-    mpGfxState->setFbo(mpInternalFbo);
-
-    // Whenever we resize, we'd better force accumulation to restart
+    // Our history textures are resized by the resource manager.  Whenever we resize, we'd better force accumulation to restart
 	mAccumCount = 0;
 }
 
@@ -114,20 +115,32 @@ void SimpleAccumulationPass::execute(RenderContext* pRenderContext)
 		mpLastCameraMatrix = mpScene->getActiveCamera()->getViewMatrix();
 	}
 
+	// If our history was (re)allocated, it holds garbage, so start over
+	if (!mpResManager->hasValidHistory(mHistoryIndex))
+		mAccumCount = 0;
+
+	// Get last frame's accumulated result, and the texture this frame's result goes into.  These swap each frame.
+	Texture::SharedPtr lastFrame = mpResManager->getHistoryRead(mHistoryIndex);
+	Texture::SharedPtr thisFrame = mpResManager->getHistoryWrite(mHistoryIndex);
+
+	// Keep an FBO for each of our two history textures, recreating it if the texture was reallocated
+	Fbo::SharedPtr &historyFbo = mpHistoryFbo[mpResManager->getHistoryWriteSlot(mHistoryIndex)];
+	if (!historyFbo || historyFbo->getColorTexture(0) != thisFrame)
+	{
+		historyFbo = Fbo::create();
+		historyFbo->attachColorTarget(thisFrame, 0);
+	}
+	mpGfxState->setFbo(historyFbo);
+
     // Set shader parameters for our accumulation
 	auto shaderVars = mpAccumShader->getVars();
 	shaderVars["PerFrameCB"]["gAccumCount"] = mAccumCount++;
-	shaderVars["gLastFrame"] = mpLastFrame;
+	shaderVars["gLastFrame"] = lastFrame;
 	shaderVars["gCurFrame"]  = inputTexture;
 
-    // Do the accumulation
+    // Do the accumulation.  The shader writes the result both to our history (for next frame) and back into 
+	//    our input/output buffer (for passes after us), so no copies are needed.
     mpAccumShader->execute(pRenderContext, mpGfxState);
-
-    // We've accumulated our result.  Copy that back to the input/output buffer
-    pRenderContext->blit(mpInternalFbo->getColorTexture(0)->getSRV(), inputTexture->getRTV());
-
-    // Keep a copy for next frame (we need this to avoid reading & writing to the same resource)
-    pRenderContext->blit(mpInternalFbo->getColorTexture(0)->getSRV(), mpLastFrame->getRTV());
 }
 
 void SimpleAccumulationPass::stateRefreshed()
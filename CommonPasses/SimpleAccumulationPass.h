@@ -43,6 +43,7 @@ protected:
 
 	// Override some functions that provide information to the RenderPipeline class
 	bool appliesPostprocess() override { return true; }
+	bool accumulatesSamples() override { return true; }
 	bool hasAnimation() override { return false; }
 
 	// A helper utility to determine if the current scene (if any) has had any camera motion
@@ -54,8 +55,8 @@ protected:
 	// State for our accumulation shader
 	FullscreenLaunch::SharedPtr   mpAccumShader;
 	GraphicsState::SharedPtr      mpGfxState;
-	Texture::SharedPtr            mpLastFrame;
-	Fbo::SharedPtr                mpInternalFbo;
+	int32_t                       mHistoryIndex = -1;   ///< Our running average (see ResourceManager::requestHistoryResource())
+	Fbo::SharedPtr                mpHistoryFbo[2];      ///< One FBO per history texture, since they alternate frame-to-frame
 
 	// We stash a copy of our current scene.  Why?  To detect if changes have occurred.
 	Scene::SharedPtr              mpScene;
@@ -21,7 +21,7 @@
 // Some global vars, used to simplify changing shader location & entry points
 namespace {
 	// Where is our shaders located?
-	const char* kFileRayTrace = "Tutorial12\\simpleDiffuseGI.rt.hlsl";
+	const char* kFileRayTrace = "CommonPasses\\simpleDiffuseGI.rt.hlsl";
 
 	// What are the entry points in that shader for various ray tracing shaders?
 	const char* kEntryPointRayGen        = "SimpleDiffuseGIRayGen";
@@ -33,6 +33,11 @@ namespace {
 	const char* kEntryPointMiss1         = "IndirectMiss";
 	const char* kEntryIndirectAnyHit     = "IndirectAnyHit";
 	const char* kEntryIndirectClosestHit = "IndirectClosestHit";
+
+	// Channels we access every frame (hashed at compile time, so lookups don't build or compare strings)
+	constexpr ChannelId kWorldPositionChannel("WorldPosition");
+	constexpr ChannelId kWorldNormalChannel("WorldNormal");
+	constexpr ChannelId kMaterialDiffuseChannel("MaterialDiffuse");
 };
 
 SimpleDiffuseGIPass::SimpleDiffuseGIPass(const std::string &outBuf) 
@@ -50,6 +55,13 @@ bool SimpleDiffuseGIPass::initialize(RenderContext* pRenderContext, ResourceMana
 	// We also need our light probe, since indirect rays may hit it
 	mpResManager->requestTextureResource(ResourceManager::kEnvironmentMap);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead("WorldPosition");
+	declareChannelRead("WorldNormal");
+	declareChannelRead("MaterialDiffuse");
+	declareChannelRead(ResourceManager::kEnvironmentMap);
+	declareChannelWrite(mOutputBuf, true);           // Our ray generation shader writes every pixel
+
 	// Create our wrapper around a ray tracing pass.  Tell it where our ray generation shader and ray-specific shaders are
 	mpRays = RayLaunch::create(kFileRayTrace, kEntryPointRayGen);
 
@@ -62,6 +74,7 @@ bool SimpleDiffuseGIPass::initialize(RenderContext* pRenderContext, ResourceMana
 	mpRays->addHitShader(kFileRayTrace, kEntryIndirectClosestHit, kEntryIndirectAnyHit);
 
 	// Now that we've passed all our shaders in, compile and (if available) setup the scene
+	updateShaderVariant();
 	mpRays->compileRayProgram();
 	if (mpScene) mpRays->setScene(mpScene);
     return true;
@@ -82,35 +95,67 @@ void SimpleDiffuseGIPass::renderGui(Gui* pGui)
 	dirty |= (int)pGui->addCheckBox(mDoIndirectGI ? "Shooting global illumination rays" : "Skipping global illumination", 
 		                            mDoIndirectGI);
 	dirty |= (int)pGui->addCheckBox(mDoCosSampling ? "Use cosine sampling" : "Use uniform sampling", mDoCosSampling);
-	if (dirty) setRefreshFlag();
+	dirty |= (int)pGui->addCheckBox("Compile toggles into shader variants", mSpecializeToggles);
+	if (dirty)
+	{
+		updateShaderVariant();
+		setRefreshFlag();
+	}
+}
+
+void SimpleDiffuseGIPass::updateShaderVariant()
+{
+	if (!mpRays) return;
+
+	// Specialized variants drop the disabled code entirely; otherwise the shader branches on the values in RayGenCB
+	if (mSpecializeToggles)
+		mpRays->setDefines({ { "DO_INDIRECT_GI",    mDoIndirectGI    ? "1" : "0" },
+		                     { "COS_SAMPLING",      mDoCosSampling   ? "1" : "0" },
+		                     { "DO_DIRECT_SHADOWS", mDoDirectShadows ? "1" : "0" } });
+	else
+		mpRays->setDefines({}, { "DO_INDIRECT_GI", "COS_SAMPLING", "DO_DIRECT_SHADOWS" });
 }
 
 
 void SimpleDiffuseGIPass::execute(RenderContext* pRenderContext)
 {
+	// Do we have all the resources we need to render?  If not, clear our output rather than leave stale data in it, and
+	//    return.  (Check before getClearedTexture(), whose clear is skipped since we normally overwrite every pixel.)
+	if (!mpRays || !mpRays->readyToRender())
+	{
+		Texture::SharedPtr pStaleTex = mpResManager->getTexture(mOutputBuf);
+		if (pStaleTex) mpResManager->clearTexture(pStaleTex, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		return;
+	}
+
 	// Get the output buffer we're writing into
 	Texture::SharedPtr pDstTex = mpResManager->getClearedTexture(mOutputBuf, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+	if (!pDstTex) return;
 
-	// Do we have all the resources we need to render?  If not, return
-	if (!pDstTex || !mpRays || !mpRays->readyToRender()) return;
+	// Did a different program variant just take over?  Then frames accumulated so far came from the old one
+	if (mpRays->getProgramGeneration() != mProgramGeneration)
+	{
+		mProgramGeneration = mpRays->getProgramGeneration();
+		setRefreshFlag();
+	}
 
 	// Set our shader variables for the ray generation shader
 	auto rayGenVars = mpRays->getRayGenVars();
-	rayGenVars["RayGenCB"]["gMinT"]         = mpResManager->getMinTDist();
-	rayGenVars["RayGenCB"]["gFrameCount"]   = mFrameCount++;
-	rayGenVars["RayGenCB"]["gDoIndirectGI"] = mDoIndirectGI;
-	rayGenVars["RayGenCB"]["gCosSampling"]  = mDoCosSampling;
-	rayGenVars["RayGenCB"]["gDirectShadow"] = mDoDirectShadows;
+	rayGenVars[mBindMinT]         = mpResManager->getMinTDist();
+	rayGenVars[mBindFrameCount]   = mFrameCount++;
+	rayGenVars[mBindDoIndirectGI] = mDoIndirectGI;
+	rayGenVars[mBindCosSampling]  = mDoCosSampling;
+	rayGenVars[mBindDirectShadow] = mDoDirectShadows;
 
 	// Pass our G-buffer textures down to the HLSL so we can shade
-	rayGenVars["gPos"]         = mpResManager->getTexture("WorldPosition");
-	rayGenVars["gNorm"]        = mpResManager->getTexture("WorldNormal");
-	rayGenVars["gDiffuseMatl"] = mpResManager->getTexture("MaterialDiffuse");
-	rayGenVars["gOutput"]      = pDstTex;
+	rayGenVars[mBindPos]         = mpResManager->getTexture(kWorldPositionChannel);
+	rayGenVars[mBindNorm]        = mpResManager->getTexture(kWorldNormalChannel);
+	rayGenVars[mBindDiffuseMatl] = mpResManager->getTexture(kMaterialDiffuseChannel);
+	rayGenVars[mBindOutput]      = pDstTex;
 
 	// Set our environment map texture for indirect rays that miss geometry 
 	auto missVars = mpRays->getMissVars(1);       // Remember, indirect rays are ray type #1
-	missVars["gEnvMap"] = mpResManager->getTexture(ResourceManager::kEnvironmentMap);
+	missVars[mBindEnvMap] = mpResManager->getTexture(ResourceManager::kEnvironmentMapId);
 
 	// Execute our shading pass and shoot indirect rays
 	mpRays->execute( pRenderContext, uvec2(pDstTex->getWidth(), pDstTex->getHeight()) );
@@ -38,9 +38,13 @@ protected:
     // Implementation of RenderPass interface
     bool initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager) override;
     void initScene(RenderContext* pRenderContext, Scene::SharedPtr pScene) override;
+    void releaseScene() override { mpScene = nullptr; if (mpRays) mpRays->releaseScene(); }
     void execute(RenderContext* pRenderContext) override;
 	void renderGui(Gui* pGui) override;
 
+	// Pass our toggles to the shader as #defines (or not), which picks which program variant we render with
+	void updateShaderVariant();
+
 	// Override some functions that provide information to the RenderPipeline class
 	bool requiresScene() override { return true; }
 	bool usesRayTracing() override { return true; }
@@ -57,7 +61,21 @@ protected:
 	bool                                    mDoIndirectGI = true;
 	bool                                    mDoCosSampling = true;
 	bool                                    mDoDirectShadows = true;
+	bool                                    mSpecializeToggles = false;  ///< Compile the toggles into the shader, rather than branching on them
+	uint64_t                                mProgramGeneration = 0;      ///< mpRays->getProgramGeneration() when we last rendered
     
 	// Various internal parameters
 	uint32_t                                mFrameCount = 0x1337u;  ///< A frame counter to vary random numbers over time
+
+	// Per-frame ray generation shader variables
+	SimpleVars::Binding                     mBindMinT         { "RayGenCB", "gMinT" };
+	SimpleVars::Binding                     mBindFrameCount   { "RayGenCB", "gFrameCount" };
+	SimpleVars::Binding                     mBindDoIndirectGI { "RayGenCB", "gDoIndirectGI" };
+	SimpleVars::Binding                     mBindCosSampling  { "RayGenCB", "gCosSampling" };
+	SimpleVars::Binding                     mBindDirectShadow { "RayGenCB", "gDirectShadow" };
+	SimpleVars::Binding                     mBindPos          { "gPos" };
+	SimpleVars::Binding                     mBindNorm         { "gNorm" };
+	SimpleVars::Binding                     mBindDiffuseMatl  { "gDiffuseMatl" };
+	SimpleVars::Binding                     mBindOutput       { "gOutput" };
+	SimpleVars::Binding                     mBindEnvMap       { "gEnvMap" };
 };
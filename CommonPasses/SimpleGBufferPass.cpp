@@ -37,6 +37,14 @@ bool SimpleGBufferPass::initialize(RenderContext* pRenderContext, ResourceManage
 	mpResManager->requestTextureResource("MaterialExtraParams");
 	mpResManager->requestTextureResource("Z-Buffer", ResourceFormat::D24UnormS8, ResourceManager::kDepthBufferFlags);
 
+	// Let the pipeline know which channels we produce (so it can skip us if nobody needs them)
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse");
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+	declareChannelWrite("Z-Buffer");
+
     // Since we're rasterizing, we need to define our raster pipeline state (though we use the defaults)
     mpGfxState = GraphicsState::create();
 
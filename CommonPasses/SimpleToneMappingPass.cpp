@@ -32,6 +32,10 @@ bool SimpleToneMappingPass::initialize(RenderContext* pRenderContext, ResourceMa
 	mpResManager->requestTextureResource(mInChannel);
 	mpResManager->requestTextureResource(mOutChannel);
 
+	// Let the pipeline know how data flows through this pass
+	declareChannelRead(mInChannel);
+	declareChannelWrite(mOutChannel);
+
 	// The Falcor tonemapper can screw with DX pipeline state, so we'll want to create a disposible state object.
 	mpGfxState = GraphicsState::create();
 
@@ -39,6 +39,7 @@ protected:
 
 	// Override some functions that provide information to the RenderPipeline class
 	bool appliesPostprocess() override { return true; }
+	bool isDisplayOnly() override { return true; }      // Changing tonemapping settings shouldn't reset accumulation upstream
 
       
 	GraphicsState::SharedPtr    mpGfxState;
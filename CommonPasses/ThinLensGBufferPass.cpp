@@ -32,6 +32,13 @@ namespace {
 	// If we want to jitter the camera to antialias using traditional a traditional 8x MSAA pattern, 
 	//     use these positions (which are in the range [-8.0...8.0], so divide by 16 before use)
 	const float kMSAA[8][2] = { { 1,-3 },{ -1,3 },{ 5,1 },{ -3,-5 },{ -5,5 },{ -7,-1 },{ 3,7 },{ 7,-7 } };
+
+	// Channels we access every frame (hashed at compile time, so lookups don't build or compare strings)
+	constexpr ChannelId kWorldPositionChannel("WorldPosition");
+	constexpr ChannelId kWorldNormalChannel("WorldNormal");
+	constexpr ChannelId kMaterialDiffuseChannel("MaterialDiffuse");
+	constexpr ChannelId kMaterialSpecRoughChannel("MaterialSpecRough");
+	constexpr ChannelId kMaterialExtraParamsChannel("MaterialExtraParams");
 };
 
 bool ThinLensGBufferPass::initialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager)
@@ -46,6 +53,13 @@ bool ThinLensGBufferPass::initialize(RenderContext* pRenderContext, ResourceMana
 	mpResManager->requestTextureResource("MaterialSpecRough");
 	mpResManager->requestTextureResource("MaterialExtraParams");
 
+	// Let the pipeline know which channels we produce (so it can skip us if nobody needs them)
+	declareChannelWrite("WorldPosition");
+	declareChannelWrite("WorldNormal");
+	declareChannelWrite("MaterialDiffuse", true);     // Hits write material colors, misses write the background
+	declareChannelWrite("MaterialSpecRough");
+	declareChannelWrite("MaterialExtraParams");
+
 	// Create our wrapper around a ray tracing pass.  Tell it where our shaders are, then compile/link the program
 	mpRays = RayLaunch::create(kFileRayTrace, kEntryPointRayGen);
 	mpRays->addMissShader(kFileRayTrace, kEntryPointMiss0);
@@ -111,12 +125,14 @@ void ThinLensGBufferPass::execute(RenderContext* pRenderContext)
 	// Check that we're ready to render
 	if (!mpRays || !mpRays->readyToRender()) return;
 
-	// Load our textures, but ask the resource manager to clear them to black before returning them
-	Texture::SharedPtr wsPos = mpResManager->getClearedTexture("WorldPosition", vec4(0, 0, 0, 0));
-	Texture::SharedPtr wsNorm = mpResManager->getClearedTexture("WorldNormal", vec4(0, 0, 0, 0));
-	Texture::SharedPtr matDif = mpResManager->getClearedTexture("MaterialDiffuse", vec4(0, 0, 0, 0));
-	Texture::SharedPtr matSpec = mpResManager->getClearedTexture("MaterialSpecRough", vec4(0, 0, 0, 0));
-	Texture::SharedPtr matExtra = mpResManager->getClearedTexture("MaterialExtraParams", vec4(0, 0, 0, 0));
+	// Clear our textures to black in one batch before grabbing them.  (Channels we overwrite entirely, like
+	//    MaterialDiffuse, are skipped by the resource manager.)
+	mpResManager->clearChannels({ kWorldPositionChannel, kWorldNormalChannel, kMaterialDiffuseChannel, kMaterialSpecRoughChannel, kMaterialExtraParamsChannel }, vec4(0, 0, 0, 0));
+	Texture::SharedPtr wsPos = mpResManager->getTexture(kWorldPositionChannel);
+	Texture::SharedPtr wsNorm = mpResManager->getTexture(kWorldNormalChannel);
+	Texture::SharedPtr matDif = mpResManager->getTexture(kMaterialDiffuseChannel);
+	Texture::SharedPtr matSpec = mpResManager->getTexture(kMaterialSpecRoughChannel);
+	Texture::SharedPtr matExtra = mpResManager->getTexture(kMaterialExtraParamsChannel);
 
 	// Compute parameters based on our user-exposed controls
 	mLensRadius = mFocalLength / (2.0f * mFStop);
@@ -15,6 +15,7 @@ bool RayTracingInOneWeekendDemo::initialize(RenderContext::SharedPtr pRenderCont
 	//    we need to output to the standardized output texture; request access to that.
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
+	declareChannelWrite(ResourceManager::kOutputChannel, true);    // Our ray generation shader writes every pixel
 
 	// Build our scene.  This is somewhat ugly, since spheres aren't currently abstracted
 	//    in our framework (which was designed for raster... without analytic spheres)
@@ -39,6 +40,7 @@ void RayTracingInOneWeekendDemo::renderGui(Gui* pGui)
 	// Draw the widgets in our GUI.  This uses an immediate mode GUI (i.e., dear_imgui)
 	int dirty = 0;
 	dirty |= (int)pGui->addIntVar("spp / frame", mNumSamples, 1, 16);  
+	pGui->addText((std::to_string(mNumSamples) + " spp in " + std::to_string(mLaunchesLastFrame) + " ray launch(es) last frame").c_str());
 	dirty |= (int)pGui->addIntVar("ray depth", mMaxDepth, 1, 16); 
 	dirty |= (int)pGui->addCheckBox(mUseDoF ? "using depth of field" : "no depth of field", mUseDoF);
 	if (mUseDoF)
@@ -82,6 +84,7 @@ void RayTracingInOneWeekendDemo::execute(RenderContext::SharedPtr pRenderContext
 	sharedVars["SharedCB"]["gFocalLen"]        = mThinLensFocus;            // Thin lens approx's focal length
 	sharedVars["SharedCB"]["gLensRadius"]      = !mUseDoF ? 0.0f : float(mThinLensFocus / (2.0f * mFNum));
 	sharedVars["SharedCB"]["gPixelMultiplier"] = 1.0f / float(mNumSamples); // For weighing multiple spp correctly
+	sharedVars["SharedCB"]["gSamplesPerPixel"] = uint32_t( mNumSamples );   // Samples per pixel, all taken in one launch
 	sharedVars["SharedCB"]["gShowDiffuseTextures"] = mShowDiffuseTextures;
 	sharedVars["SharedCB"]["gShowNormalMaps"]      = mShowNormalMaps;
 	sharedVars["SharedCB"]["gPerturbRefractions"]  = mPerturbRefractions;
@@ -96,15 +99,14 @@ void RayTracingInOneWeekendDemo::execute(RenderContext::SharedPtr pRenderContext
 	sharedVars["gAABBData"]   = mpGpuBufAABBs;
 	sharedVars["gMatlData"]   = mpGpuBufMatls;
 
-	// Launch our ray tracing.  This is almost certainly *not* the best way to do multiple samples per pixel
-	for (int i = 0; i < mNumSamples; i++)
-	{
-		// Update the frame count (gives different random numbers per sample)
-		sharedVars["SharedCB"]["gFrameCount"] = mFrameCount++;
+	// Update the frame count (gives different random numbers each frame).  All mNumSamples samples
+	//    per pixel are taken (and averaged) by the ray generation shader, so we only need one launch.
+	sharedVars["SharedCB"]["gFrameCount"] = mFrameCount++;
 
-		// Lauch our rays!
-		mpRays->execute(pRenderContext, mpResManager->getScreenSize(), mpCamera);
-	}
+	// Lauch our rays!
+	uint64_t launchesBefore = mpRays->getLaunchCount();
+	mpRays->execute(pRenderContext, mpResManager->getScreenSize(), mpCamera);
+	mLaunchesLastFrame = mpRays->getLaunchCount() - launchesBefore;
 }
 
 // This callback gets executed whenever a mouse event occurs
@@ -48,6 +48,7 @@ protected:
 
 	// An internal frame counter.  Used in HLSL to generate new random seeds each frame
 	uint32_t                    mFrameCount = 0;
+	uint64_t                    mLaunchesLastFrame = 0;  // How many ray launches did our last execute() take?  (Shown in the GUI)
 
 	// Override a function that provides information to the RenderPipeline 
 	bool hasAnimation() override { return false; }       // Gets rid of a UI control that makes no sense for this demo
@@ -23,9 +23,9 @@ __import Raytracing;                 // See "Data/raytracing.slang" in the binar
 shared cbuffer SharedCB
 {
 	float  gMinT;            // A small epsilon to (help) avoid self-intersections
-	uint   gFrameCount;      // A counter that changes each frame to update our random seed
 	uint   gMaxDepth;        // The maximum recursion depth for our ray tracing
 	float  gPixelMultiplier; // If doing multiple samples per pixel, the multiplier for each sample
+	uint   gSamplesPerPixel; // How many samples each pixel takes in one launch (averaged in the ray gen shader)
 	float  gFocalLen;        // Current focal length
 	float  gLensRadius;      // Current radius of the camera lens
 	float  gAreaLightRadius; // Perpendicular radius of directional area lights
@@ -38,6 +38,12 @@ shared cbuffer SharedCB
 	bool   gPerturbRefractions;
 }
 
+// Kept apart from SharedCB, which the C++ code only re-sends when a setting changes
+shared cbuffer PerFrameCB
+{
+	uint   gFrameCount;      // A counter that changes each frame to update our random seed
+}
+
 // The buffer containing our AABB locations
 shared Buffer<float3> gAABBData;
 shared Buffer<float4> gMatlData;
@@ -115,25 +121,31 @@ void Sphereflake()
 	// Initialize a random number generator specific to this pixel and this frame
 	uint randSeed = initRand(launchIndex.x + launchIndex.y * launchDim.x, gFrameCount);
 
-	// Convert our ray index into a ray direction in world space
-	float2 pixelOff    = float2(nextRand(randSeed), nextRand(randSeed));  // Random offset in pixel
-	float2 pixelCenter = (launchIndex + pixelOff) / launchDim;            // Pixel ID -> [0..1] over screen
-	float2 ndc = float2(2, -2) * pixelCenter + float2(-1, 1);             // Convert to [-1..1]
-	float3 rayDir = ndc.x * gCamera.cameraU + ndc.y * gCamera.cameraV + gCamera.cameraW;  // Ray to point on near plane
+	// Take all of this frame's samples in one launch, summing them here (rather than launching once per sample)
+	float3 pixelColor = float3(0.0f, 0.0f, 0.0f);
+	for (uint sampleIdx = 0; sampleIdx < gSamplesPerPixel; sampleIdx++)
+	{
+		// Convert our ray index into a ray direction in world space
+		float2 pixelOff    = float2(nextRand(randSeed), nextRand(randSeed));  // Random offset in pixel
+		float2 pixelCenter = (launchIndex + pixelOff) / launchDim;            // Pixel ID -> [0..1] over screen
+		float2 ndc = float2(2, -2) * pixelCenter + float2(-1, 1);             // Convert to [-1..1]
+		float3 rayDir = ndc.x * gCamera.cameraU + ndc.y * gCamera.cameraV + gCamera.cameraW;  // Ray to point on near plane
+
+		// Where is the focal point on the near plane for this pixel? 
+		rayDir /= length(gCamera.cameraW);
+		float3 focalPt = gCamera.posW + gFocalLen * rayDir;  
 
-	// Where is the focal point on the near plane for this pixel? 
-	rayDir /= length(gCamera.cameraW);
-	float3 focalPt = gCamera.posW + gFocalLen * rayDir;  
+		// Pick a random point on the camera lens for this pixel's ray
+		float2 rngLens = float2(6.2831853f * nextRand(randSeed), gLensRadius*nextRand(randSeed));
+		float2 lensPos = float2(cos(rngLens.x) * rngLens.y, sin(rngLens.x) * rngLens.y);
 
-	// Pick a random point on the camera lens for this pixel's ray
-	float2 rngLens = float2(6.2831853f * nextRand(randSeed), gLensRadius*nextRand(randSeed));
-	float2 lensPos = float2(cos(rngLens.x) * rngLens.y, sin(rngLens.x) * rngLens.y);
+		// Compute the ray from our random camera sample through the pixel's location on the focal plane.
+		float3 randOrig = gCamera.posW + lensPos.x * normalize(gCamera.cameraU) + lensPos.y * normalize(gCamera.cameraV);
+		float3 randDir = normalize(focalPt - randOrig);
 
-	// Compute the ray from our random camera sample through the pixel's location on the focal plane.
-	float3 randOrig = gCamera.posW + lensPos.x * normalize(gCamera.cameraU) + lensPos.y * normalize(gCamera.cameraV);
-	float3 randDir = normalize(focalPt - randOrig);
+		pixelColor += shootColorRay(randOrig, randDir, 0, randSeed);
+	}
 
-	// Output our color
-	float3 rayColor = shootColorRay(randOrig, randDir, 0, randSeed);
-	gOutTex[launchIndex] += float4(gPixelMultiplier * rayColor, 1.0f);
+	// Output our (averaged) color
+	gOutTex[launchIndex] = float4(gPixelMultiplier * pixelColor, 1.0f);
 }
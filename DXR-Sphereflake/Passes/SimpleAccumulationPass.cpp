@@ -1,7 +1,7 @@
 #include "SimpleAccumulationPass.h"
 
 namespace {
-    const char *kAccumShader = "CommonPasses\\accumulate.ps.hlsl";
+    const char *kAccumShader = "Sphereflake\\accumulate.ps.hlsl";     // Not CommonPasses' version, which accumulates in place (we blit from our own FBO)
 };
 
 SimpleAccumulationPass::SimpleAccumulationPass(const std::string &bufferToAccumulate)
@@ -18,6 +18,10 @@ bool SimpleAccumulationPass::initialize(RenderContext::SharedPtr pRenderContext,
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(mAccumChannel);
 
+	// We accumulate in place:  we both read and overwrite this channel
+	declareChannelRead(mAccumChannel);
+	declareChannelWrite(mAccumChannel);
+
 	// Create our graphics state and accumulation shader
 	mpGfxState = GraphicsState::create();
 	mpAccumShader = FullscreenLaunch::create(kAccumShader);
@@ -30,6 +30,7 @@ protected:
 
 	// Override some functions that provide information to the RenderPipeline class
 	bool appliesPostprocess() override { return true; }
+	bool accumulatesSamples() override { return true; }
 	bool hasAnimation() override { return false; }
 
 	// A helper utility to determine if the current scene (if any) has had any camera motion
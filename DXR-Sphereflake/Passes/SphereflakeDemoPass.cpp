@@ -15,6 +15,7 @@ bool SphereflakeDemo::initialize(RenderContext::SharedPtr pRenderContext, Resour
 	//    we need to output to the standardized output texture; request access to that.
 	mpResManager = pResManager;
 	mpResManager->requestTextureResource(ResourceManager::kOutputChannel);
+	declareChannelWrite(ResourceManager::kOutputChannel, true);    // Our ray generation shader writes every pixel
 
 	// Build our scene.  This is somewhat ugly, since spheres aren't currently abstracted
 	//    in our framework (which was designed for raster... without analytic spheres)
@@ -39,6 +40,7 @@ void SphereflakeDemo::renderGui(Gui* pGui)
 	// Draw the widgets in our GUI.  This uses an immediate mode GUI (i.e., dear_imgui)
 	int dirty = 0;
 	dirty |= (int)pGui->addIntVar("spp / frame", mNumSamples, 1, 16);  
+	pGui->addText((std::to_string(mNumSamples) + " spp in " + std::to_string(mLaunchesLastFrame) + " ray launch(es) last frame").c_str());
 	dirty |= (int)pGui->addIntVar("ray depth", mMaxDepth, 1, 16);
 	dirty |= (int)pGui->addCheckBox(mHemiLight ? "use hemi-light" : "no hemi-light", mHemiLight);
 	if (!mHemiLight) {
@@ -81,18 +83,16 @@ void SphereflakeDemo::execute(RenderContext::SharedPtr pRenderContext)
 	//    need to be labeled with the "shared" keyword.  (AFAIK, this is non-standard.)
 	auto sharedVars = mpRays->getGlobalVars();
 
-	// Send down our variables stored in the HLSL constant buffer "SharedCB."  
-	sharedVars["SharedCB"]["gMinT"]            = float(1.0e-4f);            // Ray offset for numerical errors
-	sharedVars["SharedCB"]["gMaxDepth"]        = uint32_t( mMaxDepth );     // Max recursive ray depth
-	sharedVars["SharedCB"]["gFocalLen"]        = mThinLensFocus;            // Thin lens approx's focal length
-	sharedVars["SharedCB"]["gLensRadius"]      = !mUseDoF ? 0.0f : float(mThinLensFocus / (2.0f * mFNum));
-	sharedVars["SharedCB"]["gPixelMultiplier"] = 1.0f / float(mNumSamples); // For weighing multiple spp correctly
-	//sharedVars["SharedCB"]["gShowDiffuseTextures"] = mShowDiffuseTextures;
-	//sharedVars["SharedCB"]["gShowNormalMaps"]      = mShowNormalMaps;
-	//sharedVars["SharedCB"]["gPerturbRefractions"]  = mPerturbRefractions;
-	sharedVars["SharedCB"]["gAreaLightRadius"] = mAreaLightRadius;          // Perpendicular radius of directional area lights
-	sharedVars["SharedCB"]["gProcTexture"] = mProcTexture ? 1.0f : 0.0f;	// 1.0 means use procedural texture
-	sharedVars["SharedCB"]["gHemiLight"] = mHemiLight ? 1.0f : 0.0f;	// 1.0 means use cosine-weighted hemispherical light
+	// Fill in our copy of the HLSL constant buffer "SharedCB."  (It gets sent down, all at once, when it changes.)
+	mSharedCB->gMinT            = float(1.0e-4f);            // Ray offset for numerical errors
+	mSharedCB->gMaxDepth        = uint32_t( mMaxDepth );     // Max recursive ray depth
+	mSharedCB->gFocalLen        = mThinLensFocus;            // Thin lens approx's focal length
+	mSharedCB->gLensRadius      = !mUseDoF ? 0.0f : float(mThinLensFocus / (2.0f * mFNum));
+	mSharedCB->gPixelMultiplier = 1.0f / float(mNumSamples); // For weighing multiple spp correctly
+	mSharedCB->gSamplesPerPixel = uint32_t( mNumSamples );   // Samples per pixel, all taken in one launch
+	mSharedCB->gAreaLightRadius = mAreaLightRadius;          // Perpendicular radius of directional area lights
+	mSharedCB->gProcTexture     = mProcTexture ? 1.0f : 0.0f; // 1.0 means use procedural texture
+	mSharedCB->gHemiLight       = mHemiLight ? 1.0f : 0.0f;   // 1.0 means use cosine-weighted hemispherical light
 
 	// Send down our input and output textures to the HLSL shader
 	//sharedVars["gEarthTex"]   = mpEarthTex;
@@ -104,15 +104,15 @@ void SphereflakeDemo::execute(RenderContext::SharedPtr pRenderContext)
 	sharedVars["gAABBData"]   = mpGpuBufAABBs;
 	sharedVars["gMatlData"]   = mpGpuBufMatls;
 
-	// Launch our ray tracing.  This is almost certainly *not* the best way to do multiple samples per pixel
-	for (int i = 0; i < mNumSamples; i++)
-	{
-		// Update the frame count (gives different random numbers per sample)
-		sharedVars["SharedCB"]["gFrameCount"] = mFrameCount++;
+	// Update the frame count (gives different random numbers each frame).  All mNumSamples samples
+	//    per pixel are taken (and averaged) by the ray generation shader, so we only need one launch.
+	sharedVars[mBindFrameCount] = mFrameCount++;
+	mSharedCB.upload(sharedVars);
 
-		// Lauch our rays!
-		mpRays->execute(pRenderContext, mpResManager->getScreenSize(), mpCamera);
-	}
+	// Lauch our rays!
+	uint64_t launchesBefore = mpRays->getLaunchCount();
+	mpRays->execute(pRenderContext, mpResManager->getScreenSize(), mpCamera);
+	mLaunchesLastFrame = mpRays->getLaunchCount() - launchesBefore;
 }
 
 // This callback gets executed whenever a mouse event occurs
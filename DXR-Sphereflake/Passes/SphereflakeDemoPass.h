@@ -4,6 +4,7 @@
 #pragma once
 #include "../SharedUtils/RenderPass.h"   // The base class for all render passes in our app
 #include "../SharedUtils/RayLaunch.h"    // The simple wrapper layer around DXR launches
+#include "../SharedUtils/ConstantBufferStruct.h"  // Lets us send a whole HLSL cbuffer in one go
 #include <random>
 
 class SphereflakeDemo : public RenderPass, inherit_shared_from_this<RenderPass, SphereflakeDemo>
@@ -81,6 +82,35 @@ protected:
 
 	// An internal frame counter.  Used in HLSL to generate new random seeds each frame
 	uint32_t                    mFrameCount = 0;
+	uint64_t                    mLaunchesLastFrame = 0;  // How many ray launches did our last execute() take?  (Shown in the GUI)
+
+	// A C++ copy of the HLSL constant buffer "SharedCB" (in sphereflake.rt.hlsl).  Must match its layout exactly;
+	//    this is checked (and errors reported) the first time it's uploaded.
+	struct SharedCB
+	{
+		float    gMinT;
+		uint32_t gMaxDepth;
+		float    gPixelMultiplier;
+		uint32_t gSamplesPerPixel;
+		float    gFocalLen;
+		float    gLensRadius;
+		float    gAreaLightRadius;
+		float    gProcTexture;
+		float    gHemiLight;
+		uint32_t gShowDiffuseTextures;   // HLSL bools are 4 bytes
+		uint32_t gShowNormalMaps;
+		uint32_t gPerturbRefractions;    // (12 fields x 4 bytes; no padding needed to reach a multiple of 16)
+
+		static std::vector<CBufferField> getLayout()
+		{
+			return { CBUFFER_FIELD(SharedCB, gMinT),            CBUFFER_FIELD(SharedCB, gMaxDepth),        CBUFFER_FIELD(SharedCB, gPixelMultiplier),
+			         CBUFFER_FIELD(SharedCB, gSamplesPerPixel), CBUFFER_FIELD(SharedCB, gFocalLen),        CBUFFER_FIELD(SharedCB, gLensRadius),
+			         CBUFFER_FIELD(SharedCB, gAreaLightRadius), CBUFFER_FIELD(SharedCB, gProcTexture),     CBUFFER_FIELD(SharedCB, gHemiLight),
+			         CBUFFER_FIELD(SharedCB, gShowDiffuseTextures), CBUFFER_FIELD(SharedCB, gShowNormalMaps), CBUFFER_FIELD(SharedCB, gPerturbRefractions) };
+		}
+	};
+	ConstantBufferStruct<SharedCB> mSharedCB { "SharedCB" };
+	SimpleVars::Binding            mBindFrameCount { "PerFrameCB", "gFrameCount" };   ///< Changes every frame, so kept out of SharedCB
 
 	// Override a function that provides information to the RenderPipeline 
 	bool hasAnimation() override { return false; }       // Gets rid of a UI control that makes no sense for this demo
@@ -0,0 +1,92 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "AccelBuildPolicy.h"
+
+namespace {
+	const uint32_t kStaticFlags = AccelBuildPolicy::FastTrace | AccelBuildPolicy::AllowCompaction;
+	const uint32_t kDeformingFlags = AccelBuildPolicy::FastBuild | AccelBuildPolicy::AllowUpdate;
+};
+
+AccelBuildPolicy::Selection AccelBuildPolicy::select(const SceneDesc &desc, Mode mode)
+{
+	Selection sel;
+	uint64_t staticTriangles = 0, deformingTriangles = 0;
+	for (const MeshDesc &mesh : desc.meshes)
+	{
+		uint32_t flags = mesh.deforming ? kDeformingFlags : kStaticFlags;
+		if (mode == Mode::PreferFastTrace && mesh.deforming) flags = FastTrace | AllowUpdate;
+		if (mode == Mode::PreferFastBuild) flags = FastBuild | (mesh.deforming ? AllowUpdate : None);
+		sel.meshFlags.push_back(flags);
+
+		if (mesh.deforming)
+		{
+			sel.deformingMeshes++;
+			deformingTriangles += mesh.triangleCount;
+		}
+		else
+		{
+			sel.staticMeshes++;
+			staticTriangles += mesh.triangleCount;
+		}
+	}
+
+	// The top level changes whenever an instance moves or a mesh deforms (which changes its bounds)
+	sel.dynamicInstances = desc.hasAnimations || desc.hasObjectPaths || sel.deformingMeshes > 0;
+	if (mode == Mode::PreferFastTrace)      sel.sceneFlags = FastTrace | (sel.dynamicInstances ? AllowUpdate : None);
+	else if (mode == Mode::PreferFastBuild) sel.sceneFlags = FastBuild | (sel.dynamicInstances ? AllowUpdate : None);
+	else                                    sel.sceneFlags = sel.dynamicInstances ? kDeformingFlags : FastTrace;
+
+	// One set for everything.  If the top level changes after load, it needs updates allowed; beyond that, favor
+	//     whichever kind of geometry has the most triangles, since that's where most of the build (or trace) time goes.
+	if (mode == Mode::PreferFastBuild)
+		sel.combinedFlags = FastBuild;
+	else if (mode == Mode::PreferFastTrace || staticTriangles >= deformingTriangles)
+		sel.combinedFlags = kStaticFlags;
+	else
+		sel.combinedFlags = FastBuild;
+	if (sel.dynamicInstances) sel.combinedFlags |= AllowUpdate;
+	return sel;
+}
+
+std::string AccelBuildPolicy::toString(uint32_t flags)
+{
+	static const std::pair<uint32_t, const char*> kNames[] = {
+		{ AllowUpdate, "AllowUpdate" }, { AllowCompaction, "AllowCompaction" }, { FastTrace, "FastTrace" },
+		{ FastBuild, "FastBuild" }, { MinimizeMemory, "MinimizeMemory" },
+	};
+	std::string str;
+	for (const auto &name : kNames)
+	{
+		if (!(flags & name.first)) continue;
+		if (!str.empty()) str += " | ";
+		str += name.second;
+	}
+	return str.empty() ? std::string("None") : str;
+}
+
+const char *AccelBuildPolicy::toString(Mode mode)
+{
+	switch (mode)
+	{
+	case Mode::Automatic:       return "Automatic";
+	case Mode::PreferFastTrace: return "Prefer fast trace";
+	case Mode::PreferFastBuild: return "Prefer fast build";
+	}
+	return "";
+}
@@ -0,0 +1,96 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Picks acceleration structure build flags for a scene, per mesh (bottom level) and for the scene (top level).
+
+Static geometry is built once and traced every frame, so it prefers fast traces and allows compaction.  Meshes
+that deform (e.g., skinned meshes) are rebuilt every frame, so they prefer fast builds and allow in-place updates.
+The top level is rebuilt whenever an instance moves, so it prefers fast builds (and allows updates) as soon as
+anything in the scene animates.  A camera path on its own doesn't move any geometry, so it changes nothing.
+
+Falcor 3.1 builds every structure in an RtScene with one set of flags, so Selection::combinedFlags folds the
+per-structure choices into the one set that serves the scene best.
+
+Flag values match D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS (and Falcor's RtBuildFlags), so they can
+be cast straight across.
+
+This class has no Falcor dependencies, so the selection logic can be built and tested standalone.
+
+Usage:
+     AccelBuildPolicy::SceneDesc desc;
+     desc.meshes = { { false, 10000 }, { true, 2000 } };   // A static mesh and a skinned one
+     desc.hasObjectPaths = true;
+     AccelBuildPolicy::Selection sel = AccelBuildPolicy::select(desc, AccelBuildPolicy::Mode::Automatic);
+     RtBuildFlags flags = RtBuildFlags(uint32_t(sel.combinedFlags));
+*/
+class AccelBuildPolicy
+{
+public:
+	enum Flags : uint32_t
+	{
+		None            = 0x0,
+		AllowUpdate     = 0x1,
+		AllowCompaction = 0x2,
+		FastTrace       = 0x4,
+		FastBuild       = 0x8,
+		MinimizeMemory  = 0x10,
+	};
+
+	enum class Mode : uint32_t
+	{
+		Automatic,          ///< Decide from what animates in the scene
+		PreferFastTrace,    ///< Everything prefers fast traces (deforming meshes still allow updates)
+		PreferFastBuild,    ///< Everything prefers fast builds, without compaction
+	};
+
+	struct MeshDesc
+	{
+		bool      deforming = false;     ///< Vertices change after load (skinning, morphing...)
+		uint64_t  triangleCount = 0;
+	};
+
+	struct SceneDesc
+	{
+		std::vector<MeshDesc>  meshes;
+		bool                   hasAnimations = false;    ///< Model animations (moving mesh instances, even without skinning)
+		bool                   hasObjectPaths = false;   ///< Paths moving models or lights
+		bool                   hasCameraPath = false;    ///< A path moving the camera
+	};
+
+	struct Selection
+	{
+		std::vector<uint32_t>  meshFlags;                ///< Per mesh (bottom-level structure)
+		uint32_t               sceneFlags = None;        ///< For the top-level structure
+		uint32_t               combinedFlags = None;     ///< One set for all structures, for APIs (like Falcor 3.1) that only take one
+		uint32_t               staticMeshes = 0;
+		uint32_t               deformingMeshes = 0;
+		bool                   dynamicInstances = false; ///< Will the top level be rebuilt or updated after load?
+	};
+
+	static Selection select(const SceneDesc &desc, Mode mode);
+
+	// E.g., "FastTrace | AllowCompaction"
+	static std::string toString(uint32_t flags);
+	static const char *toString(Mode mode);
+};
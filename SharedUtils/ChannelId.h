@@ -0,0 +1,54 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include "Fnv1a.h"
+
+/** A compile-time hashed identifier for a ResourceManager channel.
+
+Looking up channels by std::string requires building a string and comparing it against every channel name.
+A ChannelId hashes its name (64-bit FNV-1a) when it is constructed, which for constexpr instances happens at
+compile time.  ResourceManager then resolves the hash to a channel index with a single table lookup.  
+
+Usage:
+     namespace { constexpr ChannelId kWorldPos("WorldPosition"); };
+     ...
+     Texture::SharedPtr pPos = mpResManager->getTexture(kWorldPos);
+
+The name pointer is kept (for debugging and collision checks), so only construct ChannelIds from string 
+literals or other strings that outlive the identifier.
+*/
+class ChannelId
+{
+public:
+	constexpr explicit ChannelId(const char* name) : mHash(hash(name)), mpName(name) {}
+
+	constexpr uint64_t getHash() const  { return mHash; }
+	constexpr const char* getName() const { return mpName; }
+
+	// The hash of a channel name (see Fnv1a.h).  ResourceManager uses the same function for string lookups.
+	static constexpr uint64_t hash(const char* str) { return Fnv1a::hashString(str); }
+
+	constexpr bool operator==(const ChannelId& other) const { return mHash == other.mHash; }
+	constexpr bool operator!=(const ChannelId& other) const { return mHash != other.mHash; }
+
+protected:
+	uint64_t    mHash;
+	const char* mpName;
+};
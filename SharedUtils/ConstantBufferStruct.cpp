@@ -0,0 +1,68 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "ConstantBufferStruct.h"
+
+using namespace Falcor;
+
+bool CBufferStructUtils::verifyLayout(ConstantBuffer *pCB, const std::string &cbName, const std::vector<CBufferField> &fields, size_t structSize)
+{
+	if (!pCB)
+	{
+		logError("ConstantBufferStruct: Shader has no cbuffer named '" + cbName + "'");
+		return false;
+	}
+
+	// Every field in the C++ struct must be at the same offset as in the HLSL
+	std::string mismatches;
+	for (auto &field : fields)
+	{
+		size_t hlslOffset = pCB->getVariableOffset(field.name);
+		if (hlslOffset == VariablesBuffer::kInvalidOffset)
+			mismatches += std::string("\n    '") + field.name + "' is not in the HLSL cbuffer";
+		else if (hlslOffset != field.offset)
+			mismatches += std::string("\n    '") + field.name + "' is at offset " + std::to_string(field.offset) + " in C++, but " + std::to_string(hlslOffset) + " in HLSL";
+	}
+
+	// ...and the struct can't be bigger than the cbuffer
+	if (structSize > pCB->getSize())
+		mismatches += "\n    C++ struct is " + std::to_string(structSize) + " bytes, but the HLSL cbuffer is only " + std::to_string(pCB->getSize());
+
+	if (!mismatches.empty())
+	{
+		logError("ConstantBufferStruct: Layout of cbuffer '" + cbName + "' does not match its C++ struct (setting its fields one at a time instead):" + mismatches);
+		return false;
+	}
+
+	// A smaller struct isn't dangerous, but it means some HLSL variables never get set
+	if (structSize < pCB->getSize())
+		logWarning("ConstantBufferStruct: C++ struct for cbuffer '" + cbName + "' only covers " + std::to_string(structSize) + " of its " + std::to_string(pCB->getSize()) + " bytes");
+	return true;
+}
+
+void CBufferStructUtils::uploadFields(ConstantBuffer *pCB, const std::vector<CBufferField> &fields, const void *pData)
+{
+	const uint8_t *pBytes = static_cast<const uint8_t*>(pData);
+	for (auto &field : fields)
+	{
+		// Skip fields the HLSL doesn't have (or that wouldn't fit where it puts them); verifyLayout() already reported them
+		size_t hlslOffset = pCB->getVariableOffset(field.name);
+		if (hlslOffset == VariablesBuffer::kInvalidOffset || hlslOffset + field.size > pCB->getSize()) continue;
+		pCB->setBlob(pBytes + field.offset, hlslOffset, field.size);
+	}
+}
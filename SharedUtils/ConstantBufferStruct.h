@@ -0,0 +1,123 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include "Falcor.h"
+#include "SimpleVars.h"
+#include "Fnv1a.h"
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/** A C++ struct that mirrors an HLSL cbuffer, uploaded with a single setBlob() rather than field-by-field.
+
+The struct must match the HLSL packing rules:  4-byte HLSL bools (use uint32_t), vectors that don't straddle
+16-byte boundaries, and explicit padding out to a multiple of 16 bytes.  It lists its fields (names as in the
+HLSL) in a static getLayout() method; when first uploaded to a set of shader vars, each field's offset is
+checked against the shader's reflection.  A mismatch is reported (once per set of vars) as an error, and the
+fields the shader does have are then set one at a time, by name, so rendering continues.
+
+Only the bytes' hash is compared between uploads, so values that change every frame (e.g., a frame counter)
+belong in a separate cbuffer; otherwise the whole struct is re-sent every frame.
+
+Usage:
+     // HLSL:  cbuffer PerFrameCB { float gMinT; uint gFrameCount; bool gDoGI; }
+     struct PerFrameCB
+     {
+          float    gMinT;
+          uint32_t gFrameCount;
+          uint32_t gDoGI;
+          uint32_t pad;
+          static std::vector<CBufferField> getLayout() { return { CBUFFER_FIELD(PerFrameCB, gMinT), CBUFFER_FIELD(PerFrameCB, gFrameCount), CBUFFER_FIELD(PerFrameCB, gDoGI) }; }
+     };
+     ConstantBufferStruct<PerFrameCB> mPerFrame { "PerFrameCB" };   // Class member
+
+     mPerFrame->gFrameCount = frameCount++;   // Each frame, set fields...
+     mPerFrame.upload(hlslVars);              // ...then upload (only if something changed)
+*/
+
+// Describes one field of a struct mirroring an HLSL cbuffer
+struct CBufferField
+{
+	const char *name;
+	size_t      offset;
+	size_t      size;
+};
+#define CBUFFER_FIELD(StructType, member)   CBufferField{ #member, offsetof(StructType, member), sizeof(((StructType*)nullptr)->member) }
+
+namespace CBufferStructUtils
+{
+	// Checks the struct's layout against the constant buffer's reflection, logging an error on mismatches
+	bool verifyLayout(Falcor::ConstantBuffer *pCB, const std::string &cbName, const std::vector<CBufferField> &fields, size_t structSize);
+
+	// The fallback for mismatched layouts:  sets each field the cbuffer has at its reflected offset
+	void uploadFields(Falcor::ConstantBuffer *pCB, const std::vector<CBufferField> &fields, const void *pData);
+};
+
+template <typename T>
+class ConstantBufferStruct
+{
+	static_assert(sizeof(T) % 16 == 0, "HLSL pads cbuffers to a multiple of 16 bytes; add padding to the C++ struct to match");
+	static_assert(std::is_trivially_copyable<T>::value, "Constant buffer structs are uploaded as raw bytes, so must be trivially copyable");
+
+public:
+	explicit ConstantBufferStruct(const std::string &cbName) : mCBufName(cbName), mData() {}
+
+	// Access the struct's fields
+	T* operator->()             { return &mData; }
+	const T* operator->() const { return &mData; }
+	T& get()                    { return mData; }
+
+	// Send the struct to the shader, if it changed since our last upload (or these are different vars than last time).
+	//    Returns false if the cbuffer doesn't exist, or its layout doesn't match (in which case the fields it does
+	//    have were still set, one at a time).
+	bool upload(const SimpleVars::SharedPtr &pVars)
+	{
+		if (!pVars || !pVars->getVars()) return false;
+
+		// New vars?  Find our cbuffer, check its layout, and force an upload
+		if (pVars->getUniqueId() != mVarsId)
+		{
+			mVarsId = pVars->getUniqueId();
+			mpCB = pVars->getVars()->getConstantBuffer(mCBufName).get();
+			mLayoutValid = CBufferStructUtils::verifyLayout(mpCB, mCBufName, T::getLayout(), sizeof(T));
+			mHasUploaded = false;
+		}
+		if (!mpCB) return false;
+
+		uint64_t hash = Fnv1a::hashBytes(&mData, sizeof(T));
+		if (mHasUploaded && hash == mUploadedHash) return mLayoutValid;
+
+		if (mLayoutValid)
+			mpCB->setBlob(&mData, 0, sizeof(T));
+		else
+			CBufferStructUtils::uploadFields(mpCB, T::getLayout(), &mData);
+		mUploadedHash = hash;
+		mHasUploaded = true;
+		return mLayoutValid;
+	}
+
+protected:
+	std::string              mCBufName;
+	T                        mData;
+	Falcor::ConstantBuffer*  mpCB = nullptr;
+	uint64_t                 mVarsId = 0;          ///< SimpleVars::getUniqueId() of the vars we last uploaded to
+	uint64_t                 mUploadedHash = 0;
+	bool                     mHasUploaded = false;
+	bool                     mLayoutValid = false;
+};
@@ -0,0 +1,50 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/** 64-bit FNV-1a, the one hash used throughout SharedUtils:  ChannelId names, ConstantBufferStruct dirty checks,
+    and the keys, payload checks, and dependency hashes of the shader and scene caches.  It is not cryptographic,
+    but it is fast, simple, and gives the same result on every run and platform (so it's safe to store on disk).
+*/
+namespace Fnv1a
+{
+	constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+	constexpr uint64_t kPrime = 1099511628211ull;
+
+	// Hashes a null-terminated string.  Recursive so it stays constexpr under C++11 rules.
+	constexpr uint64_t hashString(const char* str, uint64_t seed = kOffsetBasis)
+	{
+		return (*str == '\0') ? seed : hashString(str + 1, (seed ^ uint64_t(uint8_t(*str))) * kPrime);
+	}
+
+	// Hashes a block of memory.  Pass a previous result as <seed> to hash data incrementally.
+	inline uint64_t hashBytes(const void* pData, size_t size, uint64_t seed = kOffsetBasis)
+	{
+		const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+		uint64_t hash = seed;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= pBytes[i];
+			hash *= kPrime;
+		}
+		return hash;
+	}
+};
@@ -0,0 +1,190 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "JobSystem.h"
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+	const size_t kPrefetchChunkSize = 1 << 20;
+};
+
+bool JobSystem::Job::isFinished() const
+{
+	JobState state = mState.load();
+	return state == JobState::Completed || state == JobState::Failed || state == JobState::Cancelled;
+}
+
+std::string JobSystem::Job::getError() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mError;
+}
+
+bool JobSystem::Job::transition(JobState from, JobState to)
+{
+	return mState.compare_exchange_strong(from, to);
+}
+
+void JobSystem::Job::finish(JobState finalState, const std::string &error)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = error;
+		mState.store(finalState);
+		mWork = nullptr;   // Release anything the work captured
+	}
+	mFinishedCondition.notify_all();
+}
+
+bool JobSystem::Job::cancel()
+{
+	if (!transition(JobState::Queued, JobState::Running)) return false;   // Too late; a worker has it (or it's done)
+	finish(JobState::Cancelled);
+	return true;
+}
+
+void JobSystem::Job::wait()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mFinishedCondition.wait(lock, [this]() { return isFinished(); });
+}
+
+JobSystem::SharedPtr JobSystem::create(uint32_t numThreads)
+{
+	return SharedPtr(new JobSystem(numThreads));
+}
+
+JobSystem::SharedPtr JobSystem::getShared()
+{
+	static SharedPtr spShared = create();
+	return spShared;
+}
+
+JobSystem::JobSystem(uint32_t numThreads)
+{
+	if (numThreads == 0)
+	{
+		uint32_t hwThreads = std::thread::hardware_concurrency();
+		numThreads = (hwThreads > 1) ? hwThreads - 1 : 1;
+	}
+	for (uint32_t i = 0; i < numThreads; i++)
+		mThreads.push_back(std::thread([this]() { workerLoop(); }));
+}
+
+JobSystem::~JobSystem()
+{
+	std::deque<Job::SharedPtr> abandoned;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mShuttingDown = true;
+		abandoned.swap(mQueue);
+	}
+	mWorkAvailable.notify_all();
+
+	// Jobs nobody got to never run.  Running jobs finish before their worker exits.
+	for (auto &pJob : abandoned)
+		pJob->cancel();
+	for (auto &thread : mThreads)
+		thread.join();
+}
+
+JobSystem::Job::SharedPtr JobSystem::submit(std::function<void()> work)
+{
+	Job::SharedPtr pJob = Job::SharedPtr(new Job(std::move(work)));
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mShuttingDown)
+		{
+			pJob->cancel();
+			return pJob;
+		}
+		mQueue.push_back(pJob);
+	}
+	mWorkAvailable.notify_one();
+	return pJob;
+}
+
+void JobSystem::workerLoop()
+{
+	while (true)
+	{
+		Job::SharedPtr pJob;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWorkAvailable.wait(lock, [this]() { return mShuttingDown || !mQueue.empty(); });
+			if (mQueue.empty()) return;   // Shutting down, and nothing left to do
+			pJob = mQueue.front();
+			mQueue.pop_front();
+			mRunning++;
+		}
+
+		// Cancelled jobs stay in the queue (it's cheaper than searching for them); just skip them here
+		if (pJob->transition(JobState::Queued, JobState::Running))
+		{
+			try
+			{
+				pJob->mWork();
+				pJob->finish(JobState::Completed);
+			}
+			catch (const std::exception &e)
+			{
+				pJob->finish(JobState::Failed, e.what());
+			}
+			catch (...)
+			{
+				pJob->finish(JobState::Failed, "Unknown exception");
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mRunning--;
+		}
+		mIdle.notify_all();
+	}
+}
+
+void JobSystem::waitForIdle()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mIdle.wait(lock, [this]() { return mQueue.empty() && mRunning == 0; });
+}
+
+uint32_t JobSystem::getPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return uint32_t(mQueue.size()) + mRunning;
+}
+
+std::vector<JobSystem::Job::SharedPtr> JobSystem::prefetchFiles(const std::vector<std::string> &paths)
+{
+	std::vector<Job::SharedPtr> jobs;
+	for (const std::string &path : paths)
+	{
+		jobs.push_back(submit([path]()
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.good()) throw std::runtime_error("Can't read '" + path + "'");
+			std::vector<char> chunk(kPrefetchChunkSize);
+			while (file.read(chunk.data(), chunk.size())) {}
+		}));
+	}
+	return jobs;
+}
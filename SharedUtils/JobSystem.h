@@ -0,0 +1,133 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** A small pool of worker threads for long-running jobs (e.g., reading scene files ahead of the loader) that shouldn't stall rendering.
+
+Each submitted job moves through a simple state machine:
+     Queued -> Running -> Completed   (work returned normally)
+                       -> Failed      (work threw; see getError())
+     Queued -> Cancelled              (cancel() before a worker picked it up, or the pool shut down)
+
+Job results aren't returned directly; capture a shared_ptr to somewhere to put them in your lambda.  Poll
+isFinished() from your thread (typically once a frame), then pick up the results.
+
+This class has no Falcor dependencies, so it can be built and tested standalone.
+
+Usage:
+     auto pResult = std::make_shared<MyResult>();
+     JobSystem::Job::SharedPtr pJob = JobSystem::getShared()->submit([pResult]() { pResult->data = doSlowThing(); });
+     ...
+     if (pJob->getState() == JobSystem::JobState::Completed) use(pResult->data);
+*/
+class JobSystem : public std::enable_shared_from_this<JobSystem>
+{
+public:
+	using SharedPtr = std::shared_ptr<JobSystem>;
+	using SharedConstPtr = std::shared_ptr<const JobSystem>;
+	virtual ~JobSystem();
+
+	enum class JobState : uint32_t
+	{
+		Queued,
+		Running,
+		Completed,
+		Failed,
+		Cancelled,
+	};
+
+	class Job
+	{
+	public:
+		using SharedPtr = std::shared_ptr<Job>;
+
+		JobState getState() const { return mState.load(); }
+
+		// Is the job done, one way or another?
+		bool isFinished() const;
+
+		// If the job failed, why?
+		std::string getError() const;
+
+		// Stop the job from running, if it hasn't started yet.  Returns true if the job was cancelled.
+		bool cancel();
+
+		// Block the calling thread until the job finishes
+		void wait();
+
+	protected:
+		friend class JobSystem;
+		Job(std::function<void()> work) : mWork(std::move(work)) {}
+
+		// Move from 'from' to 'to', if we're currently in state 'from'
+		bool transition(JobState from, JobState to);
+		void finish(JobState finalState, const std::string &error = std::string());
+
+		std::function<void()>     mWork;
+		std::atomic<JobState>     mState { JobState::Queued };
+		std::string               mError;        ///< Only written before we enter a finished state
+		mutable std::mutex        mMutex;
+		std::condition_variable   mFinishedCondition;
+	};
+
+	// Create a pool with the specified number of worker threads.  0 means one fewer than the number of
+	//     hardware threads (leaving one for the render thread), but at least one.
+	static SharedPtr create(uint32_t numThreads = 0);
+
+	// A pool shared by everything in the process that wants one, created on first use
+	static SharedPtr getShared();
+
+	// Queue some work for a worker thread
+	Job::SharedPtr submit(std::function<void()> work);
+
+	// Block until every submitted job has finished
+	void waitForIdle();
+
+	// Read each file on a worker thread, so whoever reads it next (e.g., Falcor's scene loader) mostly hits the OS file
+	//     cache.  A file that can't be read fails its job.  Cancel the jobs once they'd no longer help.
+	std::vector<Job::SharedPtr> prefetchFiles(const std::vector<std::string> &paths);
+
+	// How many jobs are queued or running?
+	uint32_t getPendingCount() const;
+
+	uint32_t getThreadCount() const { return uint32_t(mThreads.size()); }
+
+protected:
+	JobSystem(uint32_t numThreads);
+
+	void workerLoop();
+
+	std::vector<std::thread>     mThreads;
+	std::deque<Job::SharedPtr>   mQueue;
+	uint32_t                     mRunning = 0;    ///< Jobs currently executing on a worker
+	bool                         mShuttingDown = false;
+	mutable std::mutex           mMutex;
+	std::condition_variable      mWorkAvailable;
+	std::condition_variable      mIdle;
+};
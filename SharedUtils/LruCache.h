@@ -0,0 +1,122 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <list>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/** A small least-recently-used cache.  Once it holds 'capacity' entries, inserting another evicts whichever
+entry was looked up (or inserted) longest ago.
+
+Key must be less-than comparable.  Lookups return a pointer into the cache, valid until the next insert(),
+erase() or clear().  No graphics dependencies, so the policy can be exercised with plain values.
+
+Usage:
+     LruCache<std::string, Program::SharedPtr> cache(8);
+     if (Program::SharedPtr *pProg = cache.find(key)) use(*pProg);    // Hit; now the most recently used
+     else cache.insert(key, buildProgram());                            // Miss; may evict the stalest entry
+*/
+template <typename Key, typename Value>
+class LruCache
+{
+public:
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+	explicit LruCache(size_t capacity = 8) : mCapacity(capacity > 0 ? capacity : 1) {}
+
+	// Look up a key.  Returns nullptr on a miss.  A hit makes the entry the most recently used.
+	Value* find(const Key& key)
+	{
+		auto it = mIndex.find(key);
+		if (it == mIndex.end())
+		{
+			mStats.misses++;
+			return nullptr;
+		}
+		mStats.hits++;
+		mEntries.splice(mEntries.begin(), mEntries, it->second);
+		return &it->second->second;
+	}
+
+	// Is this key cached?  (Doesn't count as a use.)
+	bool contains(const Key& key) const { return mIndex.find(key) != mIndex.end(); }
+
+	// Add (or replace) an entry, as the most recently used
+	void insert(const Key& key, Value value)
+	{
+		auto it = mIndex.find(key);
+		if (it != mIndex.end())
+		{
+			it->second->second = std::move(value);
+			mEntries.splice(mEntries.begin(), mEntries, it->second);
+			return;
+		}
+		mEntries.emplace_front(key, std::move(value));
+		mIndex[key] = mEntries.begin();
+		evictToCapacity();
+	}
+
+	void erase(const Key& key)
+	{
+		auto it = mIndex.find(key);
+		if (it == mIndex.end()) return;
+		mEntries.erase(it->second);
+		mIndex.erase(it);
+	}
+
+	void clear()
+	{
+		mEntries.clear();
+		mIndex.clear();
+	}
+
+	void setCapacity(size_t capacity)
+	{
+		mCapacity = capacity > 0 ? capacity : 1;
+		evictToCapacity();
+	}
+
+	size_t getSize() const      { return mEntries.size(); }
+	size_t getCapacity() const  { return mCapacity; }
+	const Stats& getStats() const { return mStats; }
+
+protected:
+	void evictToCapacity()
+	{
+		while (mEntries.size() > mCapacity)
+		{
+			mIndex.erase(mEntries.back().first);
+			mEntries.pop_back();
+			mStats.evictions++;
+		}
+	}
+
+	using EntryList = std::list<std::pair<Key, Value>>;
+	EntryList                                     mEntries;    ///< Most recently used first
+	std::map<Key, typename EntryList::iterator>   mIndex;
+	size_t                                        mCapacity;
+	Stats                                         mStats;
+};
@@ -0,0 +1,214 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "OfflineFrameLoop.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+	// Splits a command line at whitespace.  Double quotes group words (so paths can contain spaces).
+	std::vector<std::string> tokenize(const std::string& commandLine)
+	{
+		std::vector<std::string> tokens;
+		std::string cur;
+		bool inQuotes = false, haveToken = false;
+		for (char c : commandLine)
+		{
+			if (c == '"')
+			{
+				inQuotes = !inQuotes;
+				haveToken = true;
+			}
+			else if (!inQuotes && (c == ' ' || c == '\t' || c == '\r' || c == '\n'))
+			{
+				if (haveToken) tokens.push_back(cur);
+				cur.clear();
+				haveToken = false;
+			}
+			else
+			{
+				cur += c;
+				haveToken = true;
+			}
+		}
+		if (haveToken) tokens.push_back(cur);
+		return tokens;
+	}
+
+	bool parseUint(const std::string& str, uint32_t& value)
+	{
+		char* pEnd = nullptr;
+		unsigned long parsed = std::strtoul(str.c_str(), &pEnd, 10);
+		if (str.empty() || str[0] == '-' || *pEnd != '\0') return false;
+		value = uint32_t(parsed);
+		return true;
+	}
+
+	bool parseFloat(const std::string& str, float& value)
+	{
+		char* pEnd = nullptr;
+		value = std::strtof(str.c_str(), &pEnd);
+		return !str.empty() && *pEnd == '\0';
+	}
+};
+
+bool parseOfflineCommandLine(const std::string& commandLine, OfflineRenderSettings& settings, std::string& error)
+{
+	error.clear();
+	std::vector<std::string> args = tokenize(commandLine);
+	if (std::find(args.begin(), args.end(), "--offline") == args.end()) return false;
+
+	OfflineRenderSettings parsed;
+	for (size_t i = 0; i < args.size(); i++)
+	{
+		const std::string& arg = args[i];
+		size_t valueCount = (arg == "--camera") ? 6 : 1;
+		if (i + valueCount >= args.size())
+		{
+			error = "Missing value for '" + arg + "'";
+			return false;
+		}
+
+		bool ok = true;
+		if (arg == "--offline")                parsed.outputFile = args[i + 1];
+		else if (arg == "--scene")             parsed.sceneFile = args[i + 1];
+		else if (arg == "--frames")            ok = parseUint(args[i + 1], parsed.frameCount);
+		else if (arg == "--spp")               ok = parseUint(args[i + 1], parsed.samplesPerPixel);
+		else if (arg == "--seconds-per-frame") ok = parseFloat(args[i + 1], parsed.secondsPerFrame);
+		else if (arg == "--camera")
+		{
+			parsed.useSceneCamera = false;
+			for (size_t j = 0; j < 3 && ok; j++)
+			{
+				ok = parseFloat(args[i + 1 + j], parsed.cameraPosition[j]) && parseFloat(args[i + 4 + j], parsed.cameraTarget[j]);
+			}
+		}
+		else
+		{
+			error = "Unknown offline rendering argument '" + arg + "'";
+			return false;
+		}
+
+		if (!ok)
+		{
+			error = "Invalid value for '" + arg + "'";
+			return false;
+		}
+		i += valueCount;
+	}
+
+	settings = parsed;
+	return true;
+}
+
+bool OfflineFrameLoop::fail(const std::string& error)
+{
+	mError = error;
+	mHasFailed = true;
+	mIsDone = true;
+	return false;
+}
+
+std::string OfflineFrameLoop::getOutputFilename(uint32_t frameIdx) const
+{
+	std::string filename = mSettings.outputFile;
+	size_t loc = filename.find("%d");
+	if (loc != std::string::npos)
+	{
+		filename.replace(loc, 2, std::to_string(frameIdx));
+	}
+	else if (mSettings.frameCount > 1)
+	{
+		// Multiple frames but no pattern?  Insert the frame number before the extension so we don't overwrite ourselves.
+		size_t dot = filename.find_last_of('.');
+		size_t slash = filename.find_last_of("/\\");
+		if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = filename.size();
+		filename.insert(dot, "." + std::to_string(frameIdx));
+	}
+	return filename;
+}
+
+bool OfflineFrameLoop::start()
+{
+	if (mIsStarted) return !mHasFailed;
+	mIsStarted = true;
+
+	if (!mpBackend) return fail("No offline backend specified");
+	if (mSettings.outputFile.empty()) return fail("No output file specified");
+	if (mSettings.frameCount == 0 || mSettings.samplesPerPixel == 0) 
+	{
+		mIsDone = true;
+		return true;
+	}
+
+	if (!mSettings.sceneFile.empty() && !mpBackend->loadScene(mSettings.sceneFile))
+		return fail("Unable to load scene '" + mSettings.sceneFile + "'");
+
+	if (!mSettings.useSceneCamera && !mpBackend->setCamera(mSettings))
+		return fail("Unable to set camera");
+
+	return true;
+}
+
+bool OfflineFrameLoop::step()
+{
+	if (!mIsStarted && !start()) return false;
+	if (mIsDone) return false;
+
+	// Starting a new image?  Let the backend reset accumulation and advance animation.
+	if (mCurSample == 0 && !mpBackend->beginOutputFrame(mCurFrame, float(mCurFrame) * mSettings.secondsPerFrame))
+		return fail("Unable to begin frame " + std::to_string(mCurFrame));
+
+	if (!mpBackend->renderSample(mCurFrame, mCurSample))
+		return fail("Rendering failed on frame " + std::to_string(mCurFrame) + ", sample " + std::to_string(mCurSample));
+	mSamplesRendered++;
+
+	// Have we rendered all the samples for this image?  Then write it.
+	if (++mCurSample == mSettings.samplesPerPixel)
+	{
+		std::string filename = getOutputFilename(mCurFrame);
+		if (!mpBackend->writeOutput(filename))
+			return fail("Unable to write '" + filename + "'");
+
+		mFramesWritten++;
+		mCurSample = 0;
+		mIsDone = (++mCurFrame == mSettings.frameCount);
+	}
+
+	return !mIsDone;
+}
+
+bool OfflineFrameLoop::run()
+{
+	if (!start()) return false;
+	while (step()) {}
+	return !mHasFailed;
+}
+
+bool NullOfflineBackend::renderSample(uint32_t, uint32_t)
+{
+	mSampleCount++;
+
+	// "Execute" the passes in the order the pipeline would
+	if (mGraph.isCompiled())
+	{
+		for (uint32_t passIdx : mGraph.getExecutionOrder())
+			mExecutedPasses.push_back(mGraph.getPassName(passIdx));
+	}
+	return true;
+}
@@ -0,0 +1,141 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RenderGraph.h"
+
+/** Describes a non-interactive batch render
+*/
+struct OfflineRenderSettings
+{
+	std::string sceneFile;                ///< Scene to load.  If empty, the pipeline's default scene is used.
+	std::string outputFile;               ///< Where to write results.  If it contains "%d", that gets replaced by the frame number.
+	uint32_t    frameCount = 1;           ///< Number of images to write
+	uint32_t    samplesPerPixel = 1;      ///< Number of pipeline executions accumulated for each image
+	float       secondsPerFrame = 0.0f;   ///< Animation time between written frames (0 = static scene)
+
+	// If useSceneCamera is false, the scene's active camera is moved to this position / orientation
+	bool        useSceneCamera = true;
+	float       cameraPosition[3] = { 0.0f, 0.0f, 0.0f };
+	float       cameraTarget[3] = { 0.0f, 0.0f, -1.0f };
+	float       cameraUp[3] = { 0.0f, 1.0f, 0.0f };
+};
+
+/** Fills in <settings> from a command line of the form:
+        --offline <outputFile> [--scene <file>] [--frames <n>] [--spp <n>] [--seconds-per-frame <t>]
+                               [--camera <posX> <posY> <posZ> <targetX> <targetY> <targetZ>]
+    Arguments may be quoted.  Returns true if the command line asks for an offline render and is well formed.
+    Returns false (with <error> empty) if there's no --offline, or (with <error> set) if the arguments are malformed.
+*/
+bool parseOfflineCommandLine(const std::string& commandLine, OfflineRenderSettings& settings, std::string& error);
+
+/** The device-dependent half of an offline render.  The OfflineFrameLoop decides what happens when; a backend does it.
+*/
+class OfflineBackend
+{
+public:
+	virtual ~OfflineBackend() = default;
+
+	// Each returns false on failure, which aborts the batch render
+	virtual bool loadScene(const std::string& filename) = 0;
+	virtual bool setCamera(const OfflineRenderSettings& settings) = 0;
+	virtual bool beginOutputFrame(uint32_t frameIdx, float animationTime) = 0;   ///< Should reset any temporal accumulation
+	virtual bool renderSample(uint32_t frameIdx, uint32_t sampleIdx) = 0;        ///< Execute the pipeline once
+	virtual bool writeOutput(const std::string& filename) = 0;                   ///< Save the pipeline's output channel
+};
+
+/** Orchestrates a batch render:  loads the scene, positions the camera, and for each output frame renders 
+    the requested number of samples before writing the result.  The loop is driven one sample at a time 
+    by step(), so it can run inside a host's frame callback, or all at once via run().
+*/
+class OfflineFrameLoop
+{
+public:
+	OfflineFrameLoop(const OfflineRenderSettings& settings, OfflineBackend* pBackend) : mSettings(settings), mpBackend(pBackend) {}
+
+	// Load the scene and set up the camera.  Returns false on error.
+	bool start();
+
+	// Render one sample (writing an image if it completes a frame).  Returns false when there's nothing left to do.
+	bool step();
+
+	// Calls start(), then step() until done.  Returns true if every frame was written.
+	bool run();
+
+	// Queries
+	bool     isDone() const              { return mIsDone; }
+	bool     hasFailed() const           { return mHasFailed; }
+	uint32_t getSamplesRendered() const  { return mSamplesRendered; }
+	uint32_t getFramesWritten() const    { return mFramesWritten; }
+	const std::string& getError() const  { return mError; }
+
+	// The file a given frame gets written to
+	std::string getOutputFilename(uint32_t frameIdx) const;
+
+protected:
+	bool fail(const std::string& error);
+
+	OfflineRenderSettings mSettings;
+	OfflineBackend*       mpBackend;
+	uint32_t              mCurFrame = 0;
+	uint32_t              mCurSample = 0;
+	uint32_t              mSamplesRendered = 0;
+	uint32_t              mFramesWritten = 0;
+	bool                  mIsStarted = false;
+	bool                  mIsDone = false;
+	bool                  mHasFailed = false;
+	std::string           mError;
+};
+
+/** A backend that renders nothing.  It records what it was asked to do (including the order in which
+    a RenderGraph would have executed passes), so the offline orchestration can be exercised without a GPU.
+*/
+class NullOfflineBackend : public OfflineBackend
+{
+public:
+	NullOfflineBackend() = default;
+
+	// Optionally provide a compiled graph; each renderSample() then records its execution order
+	void setRenderGraph(const RenderGraph& graph) { mGraph = graph; }
+
+	bool loadScene(const std::string& filename) override                        { mSceneFile = filename; return true; }
+	bool setCamera(const OfflineRenderSettings&) override                       { mCameraSet = true; return true; }
+	bool beginOutputFrame(uint32_t, float animationTime) override               { mAnimationTimes.push_back(animationTime); return true; }
+	bool renderSample(uint32_t frameIdx, uint32_t sampleIdx) override;
+	bool writeOutput(const std::string& filename) override                      { mWrittenFiles.push_back(filename); return true; }
+
+	// What happened?
+	const std::string&              getSceneFile() const      { return mSceneFile; }
+	bool                            wasCameraSet() const      { return mCameraSet; }
+	uint32_t                        getSampleCount() const    { return mSampleCount; }
+	const std::vector<float>&       getAnimationTimes() const { return mAnimationTimes; }
+	const std::vector<std::string>& getWrittenFiles() const   { return mWrittenFiles; }
+	const std::vector<std::string>& getExecutedPasses() const { return mExecutedPasses; }
+
+protected:
+	RenderGraph              mGraph;
+	std::string              mSceneFile;
+	bool                     mCameraSet = false;
+	uint32_t                 mSampleCount = 0;
+	std::vector<float>       mAnimationTimes;
+	std::vector<std::string> mWrittenFiles;
+	std::vector<std::string> mExecutedPasses;   ///< Names of passes "executed," in order, across all samples
+};
@@ -0,0 +1,205 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "PassProfiler.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+	// Convert a percentile (in [0,1]) to an index in a sorted list of <count> elements
+	uint32_t percentileIndex(float percentile, uint32_t count)
+	{
+		uint32_t idx = uint32_t(std::ceil(percentile * float(count)));
+		return (idx > 0) ? std::min(idx - 1, count - 1) : 0;
+	}
+
+	// Minimal JSON string escaping; our pass names shouldn't need more
+	std::string jsonEscape(const std::string& str)
+	{
+		std::string escaped;
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\') escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	void writeJsonStats(std::ofstream& out, const char* label, const PassProfiler::Stats& stats)
+	{
+		out << "\"" << label << "\": { \"min\": " << stats.minMs << ", \"avg\": " << stats.avgMs
+			<< ", \"p95\": " << stats.p95Ms << ", \"p99\": " << stats.p99Ms << ", \"samples\": " << stats.sampleCount << " }";
+	}
+};
+
+void PassProfiler::setPasses(const std::vector<std::string>& passNames)
+{
+	if (passNames.size() > kMaxPasses)
+	{
+		logWarning("PassProfiler: Only the first " + std::to_string(kMaxPasses) + " passes will be profiled");
+	}
+
+	mPassCount = std::min(uint32_t(passNames.size()), kMaxPasses);
+	for (uint32_t i = 0; i < mPassCount; i++)
+	{
+		mPassNames[i] = passNames[i];
+		mCpuSampleCount[i] = 0;
+		mGpuSampleCount[i] = 0;
+
+		// GPU timers are only created the first time a slot is used, so steady-state frames never allocate
+		for (uint32_t j = 0; j < kGpuLatency; j++)
+		{
+			if (!mGpuTimers[i][j]) mGpuTimers[i][j] = GpuTimer::create();
+			mGpuTimerPending[i][j] = false;
+		}
+	}
+}
+
+void PassProfiler::beginFrame()
+{
+	mInFrame = true;
+}
+
+void PassProfiler::beginPass(uint32_t passIdx)
+{
+	if (!mInFrame || passIdx >= mPassCount) return;
+
+	mCpuStart[passIdx] = Clock::now();
+	mGpuTimers[passIdx][mFrameCount % kGpuLatency]->begin();
+}
+
+void PassProfiler::endPass(uint32_t passIdx)
+{
+	if (!mInFrame || passIdx >= mPassCount) return;
+
+	uint32_t timerIdx = uint32_t(mFrameCount % kGpuLatency);
+	mGpuTimers[passIdx][timerIdx]->end();
+	mGpuTimerPending[passIdx][timerIdx] = true;
+
+	std::chrono::duration<float, std::milli> cpuTime = Clock::now() - mCpuStart[passIdx];
+	recordSample(mCpuTimes[passIdx], mCpuSampleCount[passIdx], cpuTime.count());
+}
+
+void PassProfiler::endFrame()
+{
+	if (!mInFrame) return;
+	mInFrame = false;
+
+	// Read back the GPU timers we'll reuse next frame.  They were recorded kGpuLatency-1 frames ago, so the GPU should be done with them.
+	uint32_t readIdx = uint32_t((mFrameCount + 1) % kGpuLatency);
+	for (uint32_t i = 0; i < mPassCount; i++)
+	{
+		if (!mGpuTimerPending[i][readIdx]) continue;
+		recordSample(mGpuTimes[i], mGpuSampleCount[i], float(mGpuTimers[i][readIdx]->getElapsedTime()));
+		mGpuTimerPending[i][readIdx] = false;
+	}
+
+	mFrameCount++;
+}
+
+void PassProfiler::recordSample(TimeWindow& window, uint32_t& sampleCount, float timeMs)
+{
+	window[sampleCount % kWindowSize] = timeMs;
+	sampleCount++;
+}
+
+PassProfiler::Stats PassProfiler::computeStats(const TimeWindow& window, uint32_t sampleCount) const
+{
+	Stats stats;
+	stats.sampleCount = std::min(sampleCount, kWindowSize);
+	if (stats.sampleCount == 0) return stats;
+
+	stats.lastMs = window[(sampleCount - 1) % kWindowSize];
+
+	// Copy into fixed scratch space (no allocation), then sort to get percentiles
+	std::copy(window.begin(), window.begin() + stats.sampleCount, mScratch.begin());
+	std::sort(mScratch.begin(), mScratch.begin() + stats.sampleCount);
+
+	double total = 0.0;
+	for (uint32_t i = 0; i < stats.sampleCount; i++) total += mScratch[i];
+
+	stats.minMs = mScratch[0];
+	stats.avgMs = float(total / double(stats.sampleCount));
+	stats.p95Ms = mScratch[percentileIndex(0.95f, stats.sampleCount)];
+	stats.p99Ms = mScratch[percentileIndex(0.99f, stats.sampleCount)];
+	return stats;
+}
+
+bool PassProfiler::exportCsv(const std::string& filename) const
+{
+	std::ofstream out(filename);
+	if (!out.is_open())
+	{
+		logWarning("PassProfiler: Unable to open '" + filename + "' for writing");
+		return false;
+	}
+
+	out << "pass,cpu_min_ms,cpu_avg_ms,cpu_p95_ms,cpu_p99_ms,gpu_min_ms,gpu_avg_ms,gpu_p95_ms,gpu_p99_ms,samples\n";
+	for (uint32_t i = 0; i < mPassCount; i++)
+	{
+		Stats cpu = getCpuStats(i);
+		Stats gpu = getGpuStats(i);
+		out << "\"" << mPassNames[i] << "\"," << cpu.minMs << "," << cpu.avgMs << "," << cpu.p95Ms << "," << cpu.p99Ms << ","
+			<< gpu.minMs << "," << gpu.avgMs << "," << gpu.p95Ms << "," << gpu.p99Ms << "," << gpu.sampleCount << "\n";
+	}
+	return true;
+}
+
+bool PassProfiler::exportJson(const std::string& filename) const
+{
+	std::ofstream out(filename);
+	if (!out.is_open())
+	{
+		logWarning("PassProfiler: Unable to open '" + filename + "' for writing");
+		return false;
+	}
+
+	out << "{\n  \"windowSize\": " << kWindowSize << ",\n  \"passes\": [\n";
+	for (uint32_t i = 0; i < mPassCount; i++)
+	{
+		out << "    { \"name\": \"" << jsonEscape(mPassNames[i]) << "\", ";
+		writeJsonStats(out, "cpu", getCpuStats(i));
+		out << ", ";
+		writeJsonStats(out, "gpu", getGpuStats(i));
+		out << ((i + 1 < mPassCount) ? " },\n" : " }\n");
+	}
+	out << "  ]\n}\n";
+	return true;
+}
+
+void PassProfiler::renderGui(Gui* pGui)
+{
+	char buf[256];
+	pGui->addText("Per-pass GPU time (ms):  avg / p95 / p99");
+	for (uint32_t i = 0; i < mPassCount; i++)
+	{
+		Stats gpu = getGpuStats(i);
+		sprintf_s(buf, "     %.3f / %.3f / %.3f  %s", gpu.avgMs, gpu.p95Ms, gpu.p99Ms, mPassNames[i].c_str());
+		pGui->addText(buf);
+	}
+
+	std::string filename;
+	if (pGui->addButton("Export CSV") && saveFileDialog("CSV files\0*.csv\0\0", filename))
+	{
+		exportCsv(filename);
+	}
+	if (pGui->addButton("Export JSON", true) && saveFileDialog("JSON files\0*.json\0\0", filename))
+	{
+		exportJson(filename);
+	}
+}
@@ -0,0 +1,111 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include "Falcor.h"
+#include <array>
+#include <chrono>
+
+using namespace Falcor;
+
+/** Collects CPU and GPU timings for each pass in a RenderingPipeline.
+
+Timings for the last kWindowSize frames of every pass are kept in fixed-size ring buffers, so recording 
+timings (and computing min/avg/p95/p99 statistics over that window) never allocates in the frame loop.  
+GPU timers are read back kGpuLatency frames after they are recorded, so we never stall waiting on the GPU.
+
+Usage:
+     pProfiler->setPasses({ "G-Buffer", "AO", "Copy" });  // When the pipeline changes; resets history
+     pProfiler->beginFrame();
+     pProfiler->beginPass(0);  ...  pProfiler->endPass(0);
+     pProfiler->endFrame();
+     pProfiler->exportCsv("timings.csv");
+*/
+class PassProfiler : public std::enable_shared_from_this<PassProfiler>
+{
+public:
+	using SharedPtr = std::shared_ptr<PassProfiler>;
+	using SharedConstPtr = std::shared_ptr<const PassProfiler>;
+
+	static const uint32_t kMaxPasses = 32;    ///< Passes beyond this many are not timed
+	static const uint32_t kWindowSize = 240;  ///< Number of frames of history kept per pass
+	static const uint32_t kGpuLatency = 4;    ///< Frames we wait before reading back a GPU timer
+
+	// Summary statistics over the current window, in milliseconds
+	struct Stats
+	{
+		float    minMs = 0.0f;
+		float    avgMs = 0.0f;
+		float    p95Ms = 0.0f;
+		float    p99Ms = 0.0f;
+		float    lastMs = 0.0f;
+		uint32_t sampleCount = 0;
+	};
+
+	static SharedPtr create() { return SharedPtr(new PassProfiler()); }
+	virtual ~PassProfiler() = default;
+
+	// Set the (ordered) list of passes to time.  Clears all timing history.  Call this when the pipeline changes, not per frame.
+	void setPasses(const std::vector<std::string>& passNames);
+
+	// Bracket each frame's pass execution
+	void beginFrame();
+	void endFrame();
+
+	// Bracket the execution of the pass in slot <passIdx> (i.e., the index in the list passed to setPasses())
+	void beginPass(uint32_t passIdx);
+	void endPass(uint32_t passIdx);
+
+	// Queries
+	uint32_t getPassCount() const                          { return mPassCount; }
+	const std::string& getPassName(uint32_t passIdx) const { return mPassNames[passIdx]; }
+	Stats getCpuStats(uint32_t passIdx) const              { return computeStats(mCpuTimes[passIdx], mCpuSampleCount[passIdx]); }
+	Stats getGpuStats(uint32_t passIdx) const              { return computeStats(mGpuTimes[passIdx], mGpuSampleCount[passIdx]); }
+
+	// Write per-pass statistics to disk.  Return false if the file could not be written.
+	bool exportCsv(const std::string& filename) const;
+	bool exportJson(const std::string& filename) const;
+
+	// Display a table of timings, plus buttons to export them
+	void renderGui(Gui* pGui);
+
+protected:
+	PassProfiler() = default;
+
+	using TimeWindow = std::array<float, kWindowSize>;
+	using Clock = std::chrono::high_resolution_clock;
+
+	// Sorts a copy of the valid part of <window> into our scratch space to compute percentiles
+	Stats computeStats(const TimeWindow& window, uint32_t sampleCount) const;
+
+	// Store a new sample in a pass' ring buffer
+	static void recordSample(TimeWindow& window, uint32_t& sampleCount, float timeMs);
+
+	uint32_t                                                  mPassCount = 0;
+	uint64_t                                                  mFrameCount = 0;
+	bool                                                      mInFrame = false;
+	std::array<std::string, kMaxPasses>                       mPassNames;
+	std::array<TimeWindow, kMaxPasses>                        mCpuTimes;          ///< Ring buffers of CPU times (ms), per pass
+	std::array<TimeWindow, kMaxPasses>                        mGpuTimes;          ///< Ring buffers of GPU times (ms), per pass
+	std::array<uint32_t, kMaxPasses>                          mCpuSampleCount;    ///< Total CPU samples recorded (ring index is count % kWindowSize)
+	std::array<uint32_t, kMaxPasses>                          mGpuSampleCount;    ///< Total GPU samples recorded
+	std::array<Clock::time_point, kMaxPasses>                 mCpuStart;
+	std::array<std::array<GpuTimer::SharedPtr, kGpuLatency>, kMaxPasses> mGpuTimers;
+	std::array<std::array<bool, kGpuLatency>, kMaxPasses>     mGpuTimerPending;   ///< Has this timer recorded a time we haven't read?
+	mutable TimeWindow                                        mScratch;           ///< Sort space for percentile computation
+};
@@ -0,0 +1,84 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+
+/** A pair of resources that trade roles every frame:  one holds last frame's result (and is read), the other
+receives this frame's result (and is written).  Instead of copying this frame's result into a "last frame" 
+buffer, endFrame() simply swaps which resource plays which role.
+
+Only pairs that were actually written this frame swap.  If the pass that owns a history is skipped for a frame, 
+its previous contents remain valid, rather than being replaced by a stale (or never written) buffer.
+
+Resource is expected to be a (smart) pointer type.  This class has no GPU dependencies, so the swap semantics 
+can be exercised with any stand-in resource type.
+
+Usage:
+     history.reset(texA, texB);                // Both hold garbage; hasValidHistory() is false
+     read(history.getPrevious());  write(history.getCurrent());  history.markWritten();
+     history.endFrame();                       // Now getPrevious() returns what was just written
+*/
+template <typename Resource>
+class PingPongResource
+{
+public:
+	// Provide the two resources to alternate between.  Any prior history is discarded.
+	void reset(const Resource& first, const Resource& second)
+	{
+		mResources[0] = first;
+		mResources[1] = second;
+		mCurrent = 0;
+		mWritten = false;
+		mHasHistory = false;
+	}
+
+	// The resource holding the last frame's results (only meaningful if hasValidHistory())
+	const Resource& getPrevious() const   { return mResources[1 - mCurrent]; }
+
+	// The resource to write this frame's results into.  Callers writing it should call markWritten().
+	const Resource& getCurrent() const    { return mResources[mCurrent]; }
+
+	// Which of the two resources is current (0 or 1).  Stable for the frame; useful to cache per-resource state (e.g., FBOs).
+	uint32_t getCurrentSlot() const       { return mCurrent; }
+
+	// Note that getCurrent() was (or will be) written this frame
+	void markWritten()                    { mWritten = true; }
+
+	// Does getPrevious() hold data written in an earlier frame?
+	bool hasValidHistory() const          { return mHasHistory; }
+
+	// Forget prior contents (e.g., when the data they hold no longer makes sense), without changing resources
+	void invalidate()                     { mHasHistory = false; }
+
+	// Call once per frame after all passes have run.  Swaps roles if the current resource was written.  Returns true if swapped.
+	bool endFrame()
+	{
+		if (!mWritten) return false;
+		mCurrent = 1 - mCurrent;
+		mWritten = false;
+		mHasHistory = true;
+		return true;
+	}
+
+protected:
+	Resource mResources[2];
+	uint32_t mCurrent = 0;
+	bool     mWritten = false;
+	bool     mHasHistory = false;
+};
@@ -17,6 +17,24 @@
 **********************************************************************************************************************/
 
 #include "RayLaunch.h"
+#include <algorithm>
+
+namespace {
+	// The shader cache all launches use unless told otherwise, created on first use
+	ShaderCache::SharedPtr getDefaultShaderCache()
+	{
+		static ShaderCache::SharedPtr spCache = ShaderCache::create("ShaderCache", getDataDirectoriesList());
+		return spCache;
+	}
+
+	// What we store in the shader cache for a program we couldn't create:  a zero byte, then why
+	std::vector<uint8_t> makeFailureRecord(const std::string &error)
+	{
+		std::vector<uint8_t> record(1, 0u);
+		record.insert(record.end(), error.begin(), error.end());
+		return record;
+	}
+};
 
 RayLaunch::SharedPtr RayLaunch::RayLaunch::create(const std::string &rayGenFile, const std::string& rayGenEntryPoint, int recursionDepth)
 {
@@ -29,12 +47,15 @@ RayLaunch::RayLaunch(const std::string &rayGenFile, const std::string& rayGenEnt
 	mpRayState->setMaxTraceRecursionDepth(recursionDepth);
 	mpRayProgDesc.addShaderLibrary(rayGenFile).setRayGen(rayGenEntryPoint);
 	mpLastShaderFile = rayGenFile;
+	mShaderCacheDesc.addSourceFile(rayGenFile);
+	mShaderCacheDesc.entryPoints.push_back(rayGenEntryPoint);
+	mShaderCacheDesc.target = "raytracing";
+	mpShaderCache = getDefaultShaderCache();
 
 	mpRayProg = nullptr;
 	mpRayVars = nullptr;
 	mpSceneRenderer = nullptr;
 	mpScene = nullptr;
-	mInvalidVarReflector = true;
 }
 
 uint32_t RayLaunch::addMissShader(const std::string& missShaderFile, const std::string& missEntryPoint)
@@ -43,6 +64,8 @@ uint32_t RayLaunch::addMissShader(const std::string& missShaderFile, const std::
 		mpRayProgDesc.addShaderLibrary(missShaderFile);
 
 	mpRayProgDesc.addMiss(mNumMiss, missEntryPoint);
+	mShaderCacheDesc.addSourceFile(missShaderFile);
+	mShaderCacheDesc.entryPoints.push_back(missEntryPoint);
 	return mNumMiss++;
 }
 
@@ -52,6 +75,8 @@ uint32_t RayLaunch::addHitShader(const std::string& hitShaderFile, const std::st
 		mpRayProgDesc.addShaderLibrary(hitShaderFile);
 
 	mpRayProgDesc.addHitGroup(mNumHitGroup, closestHitEntryPoint, anyHitEntryPoint);
+	mShaderCacheDesc.addSourceFile(hitShaderFile);
+	mShaderCacheDesc.entryPoints.insert(mShaderCacheDesc.entryPoints.end(), { closestHitEntryPoint, anyHitEntryPoint });
 	return mNumHitGroup++;
 }
 
@@ -61,35 +86,43 @@ uint32_t RayLaunch::addHitGroup(const std::string& hitShaderFile, const std::str
 		mpRayProgDesc.addShaderLibrary(hitShaderFile);
 
 	mpRayProgDesc.addHitGroup(mNumHitGroup, closestHitEntryPoint, anyHitEntryPoint, intersectionEntryPoint);
+	mShaderCacheDesc.addSourceFile(hitShaderFile);
+	mShaderCacheDesc.entryPoints.insert(mShaderCacheDesc.entryPoints.end(), { closestHitEntryPoint, anyHitEntryPoint, intersectionEntryPoint });
 	return mNumHitGroup++;
 }
 
 void RayLaunch::compileRayProgram()
 {
-	mpRayProg = RtProgram::create(mpRayProgDesc);
-	mpRayState->setProgram(mpRayProg);
-	mInvalidVarReflector = true;
-
-	// Since generating ray tracing variables take a while, try to do it now.
-	createRayTracingVariables();
+	// Our shaders may have changed, so previously built variants are no use
+	mVariantCache.clear();
+	buildProgram();
 }
 
 bool RayLaunch::readyToRender()
 {
-	// Do we already know everything is ready?
-	if (!mInvalidVarReflector && mpRayProg && mpRayVars) return true;
-
-	// No?  Try creating our variable reflector.
-	createRayTracingVariables();
-
-	// See if we're ready now.
-	return (mpRayProg && mpRayVars);
+	// No variables for the current scene?  (E.g., creating them failed.)  Try again.
+	if (!mVarsMatchScene) createRayTracingVariables();
+	return (mpRayProg && mpRayVars && mVarsMatchScene);
 }
 
 void RayLaunch::setMaxRecursionDepth(uint32_t maxDepth)
 {
 	if (mpRayState) mpRayState->setMaxTraceRecursionDepth(maxDepth);
-	mInvalidVarReflector = true;
+	mVarsMatchScene = false;       // readyToRender() recreates them
+}
+
+void RayLaunch::releaseScene()
+{
+	// The RtProgramVars hold the shader table (and references to the scene's resources), so let them all go
+	mpRayVars = nullptr;
+	mpGlobalVars = nullptr;
+	mpRayGenVars = nullptr;
+	mpMissVars.clear();
+	mpHitVars.clear();
+	mHitVarsBuilt.clear();
+	mpSceneRenderer = nullptr;
+	mpScene = nullptr;
+	mVarsMatchScene = false;
 }
 
 void RayLaunch::setScene(RtScene::SharedPtr pScene)
@@ -98,37 +131,164 @@ void RayLaunch::setScene(RtScene::SharedPtr pScene)
 	if (!pScene) return;
 	mpScene = pScene;
 
-	// Create a ray tracing renderer.
-	mpSceneRenderer = RtSceneRenderer::create(mpScene);
-
-	// Since the scene is an integral part of the variable reflector, we now need to update it!
-	mInvalidVarReflector = true;
+	// Get a ray tracing renderer.  (Shared with every other launch using this scene.)
+	mpSceneRenderer = SceneRegistry::getShared()->acquireRenderer(mpScene);
 
-	// Since generating our ray tracing variables take quite a while (incl. build time), check if we can do it now
-	if (mpRayProg) createRayTracingVariables();
+	// Since the scene is an integral part of the variable reflector, we now need to update it!  (Cached program
+	//     variants don't depend on the scene, so stay usable.)
+	mVarsMatchScene = false;
+	createRayTracingVariables();
 }
 
 void RayLaunch::addDefine(const std::string& name, const std::string& value)
 {
-	mpRayProg->addDefine(name, value);
-	mInvalidVarReflector = true;
+	setDefines({ { name, value } });
 }
 
 void RayLaunch::removeDefine(const std::string& name)
 {
-	mpRayProg->removeDefine(name);
-	mInvalidVarReflector = true;
+	setDefines({}, { name });
 }
 
-void RayLaunch::createRayTracingVariables()
+void RayLaunch::setDefines(const std::vector<std::pair<std::string, std::string>>& defines, const std::vector<std::string>& undefines)
+{
+	for (auto &name : undefines)
+		mShaderCacheDesc.removeDefine(name);
+	for (auto &define : defines)
+		mShaderCacheDesc.addDefine(define.first, define.second);
+	onDefinesChanged();
+}
+
+std::string RayLaunch::getDefineKey() const
+{
+	auto defines = mShaderCacheDesc.defines;
+	std::sort(defines.begin(), defines.end());
+
+	std::string key;
+	for (auto &define : defines)
+		key += define.first + "=" + define.second + "\n";
+	return key;
+}
+
+void RayLaunch::onDefinesChanged()
+{
+	// Haven't compiled yet?  Our #defines get used when we do.
+	if (!mpRayProg) return;
+
+	// Are we already using this variant?
+	std::string key = getDefineKey();
+	if (key == mActiveDefineKey) return;
+
+	// Have we built this variant recently?  Then we only need new variables.  Otherwise, build it.
+	if (RtProgram::SharedPtr *ppProgram = mVariantCache.find(key))
+	{
+		mActiveDefineKey = key;
+		useVariant(*ppProgram);
+		return;
+	}
+	buildProgram();
+}
+
+void RayLaunch::useVariant(const RtProgram::SharedPtr& pProgram)
+{
+	mpRayProg = pProgram;
+	mpRayState->setProgram(mpRayProg);
+	mProgramGeneration++;
+
+	// The program is already compiled, so this just reflects its variables and builds a shader table
+	createRayTracingVariables();
+}
+
+void RayLaunch::buildProgram()
 {
-	if (mpRayProg && mpScene)
+	// Did creating a program from these exact sources and #defines throw before?  Then don't bother failing again.
+	ShaderCache::Key cacheKey;
+	if (mpShaderCache)
 	{
-		mpRayVars = RtProgramVars::create(mpRayProg, mpScene);
-		if (!mpRayVars) return;
-		mInvalidVarReflector = false;
+		cacheKey = mpShaderCache->computeKey(mShaderCacheDesc);
+		std::vector<uint8_t> record;
+		if (mpShaderCache->load(cacheKey, record) && !record.empty() && record[0] == 0)
+		{
+			logError("RayLaunch: Not rebuilding ray tracing program, which failed to be created with these sources and #defines before "
+			         "(clear the shader cache to retry).  " + std::string(record.begin() + 1, record.end()));
+			return;
+		}
+	}
 
-		// Generate the syntactic sugar wrappers to pass users of this class
+	// Create the program.  If that throws (e.g., a missing source file), it will with these inputs every time,
+	//     so remember the failure.  (Whether variables can be created depends on the scene, so isn't recorded.)
+	RtProgram::SharedPtr pProgram;
+	std::string error;
+	try
+	{
+		pProgram = RtProgram::create(mpRayProgDesc);
+		for (auto &define : mShaderCacheDesc.defines)
+			pProgram->addDefine(define.first, define.second);
+	}
+	catch (const std::exception &e)
+	{
+		pProgram = nullptr;
+		error = e.what();
+	}
+	if (mpShaderCache && cacheKey.valid && !pProgram)
+		mpShaderCache->store(cacheKey, makeFailureRecord(error));
+
+	// Creating variables forces the compile, which is the slow part.  (They also need a scene, so might wait until we get one.)
+	RtProgramVars::SharedPtr pVars;
+	if (pProgram && mpScene)
+	{
+		try
+		{
+			pVars = RtProgramVars::create(pProgram, mpScene);
+		}
+		catch (const std::exception &e)
+		{
+			error = e.what();
+		}
+	}
+	bool built = pProgram && (pVars || !mpScene);
+
+	// If it failed, keep rendering with the program we had (if any)
+	if (!built)
+	{
+		logError("RayLaunch: Failed to build ray tracing program.  " + error);
+		return;
+	}
+
+	mpRayProg = pProgram;
+	mpRayState->setProgram(mpRayProg);
+	mActiveDefineKey = getDefineKey();
+	mProgramGeneration++;
+
+	mpRayVars = pVars;
+	mVarsMatchScene = (mpRayVars != nullptr);
+	createSimpleVars();
+
+	// Remember this (now compiled) variant, so switching back to these #defines later doesn't recompile
+	if (mpRayVars) mVariantCache.insert(mActiveDefineKey, mpRayProg);
+}
+
+void RayLaunch::createRayTracingVariables()
+{
+	if (!mpRayProg || !mpScene) return;
+
+	mpRayVars = RtProgramVars::create(mpRayProg, mpScene);
+	mVarsMatchScene = (mpRayVars != nullptr);
+	createSimpleVars();
+
+	// The program is compiled now (if it wasn't already), so worth keeping
+	if (mpRayVars) mVariantCache.insert(mActiveDefineKey, mpRayProg);
+}
+
+void RayLaunch::createSimpleVars()
+{
+	mpGlobalVars = nullptr;
+	mpRayGenVars = nullptr;
+	mpMissVars.clear();
+	mpHitVars.clear();
+	mHitVarsBuilt.clear();
+	if (mpRayVars)
+	{
 		mpGlobalVars = SimpleVars::create(mpRayVars->getGlobalVars().get());
 		mpRayGenVars = SimpleVars::create(mpRayVars->getRayGenVars().get());
 	
@@ -138,47 +298,37 @@ void RayLaunch::createRayTracingVariables()
 			mpMissVars.push_back(SimpleVars::create(mpRayVars->getMissVars(i).get()));
 		}
 
-		mpHitVars.clear();
-		for (int i = 0; i<int(mNumHitGroup); i++)
-		{
-			int32_t curHitVarsIdx = int32_t(mpHitVars.size());
-
-			SimpleVarsVector curVarVec;
-			mpHitVars.push_back(curVarVec); 
-
-			RtProgramVars::VarsVector curVars = mpRayVars->getHitVars(i);
-			for (int j = 0; j < curVars.size(); j++)
-			{
-				auto instanceVar = curVars[j];
-				mpHitVars[curHitVarsIdx].push_back(SimpleVars::create(instanceVar.get()));
-			}
-		}
+		// Wrappers for hit variables (one per geometry instance and ray type) are created when first requested
+		mpHitVars.assign(mNumHitGroup, SimpleVarsVector());
+		mHitVarsBuilt.assign(mNumHitGroup, false);
 	}
 }
 
 SimpleVars::SharedPtr RayLaunch::getGlobalVars()
 {
-	if (mInvalidVarReflector) createRayTracingVariables();
 	return mpGlobalVars;
 }
 
 SimpleVars::SharedPtr RayLaunch::getRayGenVars()
 {
-	if (mInvalidVarReflector) createRayTracingVariables();
 	return mpRayGenVars;
 }
 
 SimpleVars::SharedPtr RayLaunch::getMissVars(uint32_t rayType)
 {
-	if (mInvalidVarReflector) createRayTracingVariables();
 	return (rayType >= uint32_t(mpMissVars.size())) ? nullptr : mpMissVars[rayType];
 }
 
 RayLaunch::SimpleVarsVector &RayLaunch::getHitVars(uint32_t rayType)
 {
-	if (mInvalidVarReflector) createRayTracingVariables();
 	if (!mpRayVars || rayType >= uint32_t(mpHitVars.size())) return mDefaultHitVarList;
 
+	if (!mHitVarsBuilt[rayType])
+	{
+		for (auto &pInstanceVars : mpRayVars->getHitVars(rayType))
+			mpHitVars[rayType].push_back(SimpleVars::create(pInstanceVars.get()));
+		mHitVarsBuilt[rayType] = true;
+	}
 	return mpHitVars[rayType];
 }
 
@@ -189,11 +339,8 @@ void RayLaunch::execute(RenderContext::SharedPtr pRenderContext, uvec2 rayLaunch
 
 void RayLaunch::execute(RenderContext* pRenderContext, uvec2 rayLaunchDimensions, Camera::SharedPtr viewCamera)
 {
-	// Ok.  We're executing.  If we still have an invalid shader variable reflector, we'd better get one now!
-	if (mInvalidVarReflector) createRayTracingVariables();
-
-	// We need our shader variable reflector in order to execute!
-	if (!mpRayVars) return;
+	// We need a shader variable reflector that matches the current scene in order to execute!
+	if (!mpRayVars || !mVarsMatchScene) return;
 
 	// Get a camera pointer to pass to the renderer
 	Camera *camPtr = nullptr;
@@ -210,13 +357,15 @@ void RayLaunch::execute(RenderContext* pRenderContext, uvec2 rayLaunchDimensions
 
 	// Ok.  We're ready and have done all our error checking.  Launch the ray tracing!
 	mpSceneRenderer->renderScene(pRenderContext, mpRayVars, mpRayState, uvec3(rayLaunchDimensions.x, rayLaunchDimensions.y, 1), camPtr);
+	mLaunchCount++;
 }
 
 void RayLaunch::experimentalExecute(RenderContext::SharedPtr pRenderContext, uvec2 rayLaunchDimensions)
 {
 	// We need our shader variable reflector in order to execute!
-	if (!mpRayVars) return;
+	if (!mpRayVars || !mVarsMatchScene) return;
 
 	// Ok.  We're ready and have done all our error checking.  Launch the ray tracing!
 	mpSceneRenderer->renderScene(pRenderContext.get(), mpRayVars, mpRayState, uvec3(rayLaunchDimensions.x, rayLaunchDimensions.y, 1), nullptr);
+	mLaunchCount++;
 }
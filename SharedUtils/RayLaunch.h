@@ -20,6 +20,9 @@
 
 #include "Falcor.h"
 #include "SimpleVars.h"
+#include "ShaderCache.h"
+#include "SceneRegistry.h"
+#include "LruCache.h"
 
 /** This is a very light wrapper around Falcor's DirectX Raytracing API that removes lots of 
 boilerplate and uses the SimpleVars wrapper to access variables, constant buffers, textures, 
@@ -97,18 +100,35 @@ public:
 	// Call once you have added all the desired ray types
 	void compileRayProgram();
 
-	// Returns true if we have everything needed to call execute().
+	// Returns true if we have everything needed to call execute()
 	bool readyToRender();
 
 	// If you use #define's in this pass' shaders and need to set them programmatically, use these methods (rather
 	//     than built-in Falcor methods) to ensure setting resources via this class' syntactic sugar still works.
 	// Note:  Treat updating #defines as invalidating all resources currently bound to the shaders.
+	// Each distinct set of #defines is a program variant.  Recently used variants stay compiled, so switching back
+	//     to one only recreates its variables.  If a new variant fails to build, we keep using the previous one.
 	void addDefine(const std::string& name, const std::string& value);
 	void removeDefine(const std::string& name);
 
+	// Set and remove several #defines at once, so only the final program variant gets built (or looked up)
+	void setDefines(const std::vector<std::pair<std::string, std::string>>& defines, const std::vector<std::string>& undefines = {});
+
+	// How many program variants do we keep compiled?  (Only the active variant keeps its variables and shader table.)
+	void setVariantCacheSize(uint32_t numVariants) { mVariantCache.setCapacity(numVariants); }
+
+	// Programs we build are keyed (sources, includes, #defines, entry points) in this on-disk cache, which remembers
+	//     programs that couldn't even be created (i.e., RtProgram::create() threw).  Those aren't retried until something
+	//     they depend on changes.  By default, all launches share a cache in "ShaderCache/"; pass nullptr to disable it.
+	void setShaderCache(ShaderCache::SharedPtr pCache) { mpShaderCache = pCache; }
+
 	// When the Falcor scene you're using changes, make sure to tell us!
 	void setScene(RtScene::SharedPtr pScene);
 
+	// Drops our variables (and shader table) for the current scene, e.g., while the owning pass is inactive.  The
+	//     program and cached variants are kept; call setScene() again before executing.
+	void releaseScene();
+
 	// Sets the max recursion depth (defaults to 2)
 	void setMaxRecursionDepth(uint32_t maxDepth);
 
@@ -116,6 +136,13 @@ public:
 	void execute(RenderContext::SharedPtr pRenderContext, uvec2 rayLaunchDimensions, Camera::SharedPtr viewCamera = nullptr);
     void execute(RenderContext* pRenderContext, uvec2 rayLaunchDimensions, Camera::SharedPtr viewCamera = nullptr);
 
+	// How many times have we launched rays (i.e., called DispatchRays())?  Compare before and after a pass to count its launches.
+	uint64_t getLaunchCount() const { return mLaunchCount; }
+
+	// Changes every time we start rendering with a different program (e.g., a new variant finished building).  Passes
+	//     that accumulate over frames can watch this to know when to restart.
+	uint64_t getProgramGeneration() const { return mProgramGeneration; }
+
 	// NOTE: Experimental functionality.  Probably do not use. Beware!
 	void experimentalExecute(RenderContext::SharedPtr pRenderContext, uvec2 rayLaunchDimensions );
 
@@ -128,20 +155,38 @@ public:
 	// Get syntactic sugar to access ray gen variables
 	SimpleVars::SharedPtr getMissVars(uint32_t rayType);
 
-	// Get syntacitc sugar to access hit shader variables
+	// Get syntacitc sugar to access hit shader variables (one per geometry instance).  These get created the first
+	//     time they're asked for, so ray types whose hit variables you never set don't cost anything.
 	using SimpleVarsVector = std::vector<SimpleVars::SharedPtr>;
 	SimpleVarsVector &getHitVars(uint32_t rayType);
 
 protected:
 	RayLaunch(const std::string &rayGenFile, const std::string& rayGenEntryPoint, int recursionDepth=2);
 
+	// Build a program with our current #defines (and, if we have a scene, its variables), and start using it
+	void buildProgram();
+
+	// Create variables for our program and scene (if we have both)
 	void createRayTracingVariables();
 
+	// Create the syntactic sugar wrappers around mpRayVars
+	void createSimpleVars();
+
+	// Identifies the current set of #defines (order independent)
+	std::string getDefineKey() const;
+
+	// Our #defines changed.  Switch to a cached variant, or start building one
+	void onDefinesChanged();
+
+	// Start rendering with a previously built program variant, creating variables for it
+	void useVariant(const RtProgram::SharedPtr& pProgram);
+
 	RtProgram::SharedPtr          mpRayProg;        ///< Most abstract ray tracing pipeline (includes ray gen, miss, and hit shaders)
 	RtProgram::Desc               mpRayProgDesc;   
 	std::string                   mpLastShaderFile;
 	uint32_t                      mNumMiss      = 0;
 	uint32_t                      mNumHitGroup  = 0;
+	ShaderCache::ProgramDesc      mShaderCacheDesc; ///< Mirrors mpRayProgDesc (plus #defines)
 
 	RtProgramVars::SharedPtr      mpRayVars;        ///< Accessor / reflector for variables in all ray tracing shaders
 
@@ -150,11 +195,22 @@ protected:
 	SimpleVars::SharedPtr               mpRayGenVars;
 	std::vector<SimpleVars::SharedPtr>  mpMissVars;
 	std::vector<SimpleVarsVector>       mpHitVars;
+	std::vector<bool>                   mHitVarsBuilt;       ///< Per ray type, have we created the wrappers in mpHitVars?
 
 	RtState::SharedPtr            mpRayState;
 	RtSceneRenderer::SharedPtr    mpSceneRenderer;
 	RtScene::SharedPtr            mpScene;
-	bool                          mInvalidVarReflector = true;
+	uint64_t                      mLaunchCount = 0;
+	uint64_t                      mProgramGeneration = 0;
+	bool                          mVarsMatchScene = false;     ///< False after setScene(), until variables for the new scene are built
+
+	ShaderCache::SharedPtr        mpShaderCache;    ///< Remembers programs we failed to create (may be null)
+
+	// Recently used program variants, keyed by getDefineKey().  Just the programs, which don't depend on the scene;
+	//     variables (and their shader tables) are per scene and much bigger, so we only keep the active variant's.
+	//     Four covers every combination of two toggles (e.g., GGXGlobalIlluminationPass').
+	LruCache<std::string, RtProgram::SharedPtr>  mVariantCache { 4 };
+	std::string                            mActiveDefineKey;   ///< getDefineKey() when mpRayProg was built
 
 	// Used only to return a zero-length list of hit shaders
 	SimpleVarsVector mDefaultHitVarList;
@@ -0,0 +1,265 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "RenderGraph.h"
+#include <algorithm>
+#include <map>
+
+namespace {
+	// Appends <val> to <vec> if it is not already there.  Our lists are tiny, so a linear search is fine.
+	void pushUnique(std::vector<uint32_t>& vec, uint32_t val)
+	{
+		if (std::find(vec.begin(), vec.end(), val) == vec.end())
+			vec.push_back(val);
+	}
+
+	bool contains(const std::vector<std::string>& vec, const std::string& val)
+	{
+		return std::find(vec.begin(), vec.end(), val) != vec.end();
+	}
+};
+
+void RenderGraph::clear()
+{
+	mPasses.clear();
+	mExternalChannels.clear();
+	mExecutionOrder.clear();
+	mWarnings.clear();
+	mIsCompiled = false;
+}
+
+uint32_t RenderGraph::addPass(const std::string& name, const std::vector<std::string>& reads, const std::vector<std::string>& writes,
+	                          const std::vector<std::string>& fullCoverageWrites)
+{
+	PassNode node;
+	node.name = name;
+	node.reads = reads;
+	node.writes = writes;
+	node.fullCoverageWrites = fullCoverageWrites;
+	node.isOpaque = false;
+
+	mPasses.push_back(node);
+	mIsCompiled = false;
+	return uint32_t(mPasses.size() - 1);
+}
+
+uint32_t RenderGraph::addOpaquePass(const std::string& name)
+{
+	PassNode node;
+	node.name = name;
+	node.isOpaque = true;
+
+	mPasses.push_back(node);
+	mIsCompiled = false;
+	return uint32_t(mPasses.size() - 1);
+}
+
+void RenderGraph::addExternalChannel(const std::string& channel)
+{
+	if (!contains(mExternalChannels, channel))
+		mExternalChannels.push_back(channel);
+	mIsCompiled = false;
+}
+
+uint32_t RenderGraph::getCulledPassCount() const
+{
+	uint32_t count = 0;
+	for (auto& pass : mPasses)
+		count += pass.isCulled ? 1u : 0u;
+	return count;
+}
+
+bool RenderGraph::hasOpaquePasses() const
+{
+	for (auto& pass : mPasses)
+	{
+		if (pass.isOpaque) return true;
+	}
+	return false;
+}
+
+void RenderGraph::addEdge(uint32_t from, uint32_t to, bool isDataFlow)
+{
+	if (from == kInvalidPass || from == to) return;
+
+	pushUnique(mPasses[from].successors, to);
+	if (isDataFlow)
+	{
+		pushUnique(mPasses[from].consumers, to);
+		pushUnique(mPasses[to].producers, from);
+	}
+}
+
+bool RenderGraph::compile(const std::string& outputChannel)
+{
+	mExecutionOrder.clear();
+	mWarnings.clear();
+	for (auto& pass : mPasses)
+	{
+		pass.isCulled = false;
+		pass.producers.clear();
+		pass.consumers.clear();
+		pass.successors.clear();
+	}
+
+	// Walk the passes in pipeline order, tracking who last wrote each channel and who has read it since
+	std::map<std::string, uint32_t> lastWriter;
+	std::map<std::string, std::vector<uint32_t>> readersSinceWrite;
+	uint32_t lastOpaque = kInvalidPass;
+	bool outputWritten = false;
+
+	for (uint32_t i = 0; i < uint32_t(mPasses.size()); i++)
+	{
+		PassNode& pass = mPasses[i];
+
+		// Opaque passes might read or write anything, so they depend on everything before them.
+		if (pass.isOpaque)
+		{
+			for (uint32_t j = 0; j < i; j++)
+				addEdge(j, i, true);
+			lastOpaque = i;
+			outputWritten = true;
+			continue;
+		}
+
+		// Anything after an opaque pass must stay after it.
+		addEdge(lastOpaque, i, true);
+
+		// Read-after-write edges, plus a check that someone actually produced the data we read
+		for (auto& channel : pass.reads)
+		{
+			auto writer = lastWriter.find(channel);
+			if (writer != lastWriter.end())
+				addEdge(writer->second, i, true);
+			else if (lastOpaque == kInvalidPass && !contains(mExternalChannels, channel))
+				mWarnings.push_back("Pass '" + pass.name + "' reads channel '" + channel + "' before any pass writes it");
+		}
+
+		// Write-after-read and write-after-write edges keep the ordering the pipeline specified.  A write that
+		//    doesn't cover every texel leaves some of the prior contents visible, so it consumes the prior writer's data.
+		for (auto& channel : pass.writes)
+		{
+			for (uint32_t reader : readersSinceWrite[channel])
+				addEdge(reader, i, false);
+
+			auto writer = lastWriter.find(channel);
+			if (writer != lastWriter.end())
+				addEdge(writer->second, i, !contains(pass.fullCoverageWrites, channel));
+
+			lastWriter[channel] = i;
+			readersSinceWrite[channel].clear();
+			outputWritten = outputWritten || (channel == outputChannel);
+		}
+
+		// Remember our reads (after the writes, so read-modify-write passes don't depend on themselves)
+		for (auto& channel : pass.reads)
+		{
+			if (!contains(pass.writes, channel))
+				pushUnique(readersSinceWrite[channel], i);
+		}
+	}
+
+	// Nobody produces our output?  Then culling would remove everything; run all passes instead.
+	if (!outputWritten)
+	{
+		mWarnings.push_back("No pass writes the output channel '" + outputChannel + "'; skipping pass culling");
+		for (uint32_t i = 0; i < uint32_t(mPasses.size()); i++)
+			mExecutionOrder.push_back(i);
+		mIsCompiled = true;
+		return false;
+	}
+
+	cullUnusedPasses(outputChannel);
+	sortPasses();
+	mIsCompiled = true;
+	return true;
+}
+
+void RenderGraph::cullUnusedPasses(const std::string& outputChannel)
+{
+	// Walk backwards from the output.  A channel is "live" if a later (non-culled) pass will read it.
+	std::vector<std::string> live = { outputChannel };
+	bool everythingLive = false;
+
+	for (int32_t i = int32_t(mPasses.size()) - 1; i >= 0; i--)
+	{
+		PassNode& pass = mPasses[i];
+
+		// Once we hit an opaque pass, we have to assume it reads everything written before it.
+		if (pass.isOpaque)
+		{
+			everythingLive = true;
+			continue;
+		}
+		if (everythingLive) continue;
+
+		bool writesLiveChannel = false;
+		for (auto& channel : pass.writes)
+			writesLiveChannel = writesLiveChannel || contains(live, channel);
+
+		if (!writesLiveChannel)
+		{
+			pass.isCulled = true;
+			continue;
+		}
+
+		// Channels this pass overwrites entirely make earlier writes dead (unless we read them ourselves).  Partial 
+		//    writes leave earlier contents visible in the texels we skip, so those stay live.
+		for (auto& channel : pass.fullCoverageWrites)
+		{
+			if (!contains(pass.reads, channel))
+				live.erase(std::remove(live.begin(), live.end(), channel), live.end());
+		}
+		for (auto& channel : pass.reads)
+		{
+			if (!contains(live, channel))
+				live.push_back(channel);
+		}
+	}
+}
+
+void RenderGraph::sortPasses()
+{
+	// Kahn's algorithm over the surviving passes.  When multiple passes are ready, pick the one that comes
+	//    first in the pipeline, so the result is deterministic and matches the user-specified order.
+	uint32_t passCount = uint32_t(mPasses.size());
+	std::vector<uint32_t> inDegree(passCount, 0);
+	for (uint32_t i = 0; i < passCount; i++)
+	{
+		if (mPasses[i].isCulled) continue;
+		for (uint32_t succ : mPasses[i].successors)
+			if (!mPasses[succ].isCulled) inDegree[succ]++;
+	}
+
+	std::vector<bool> scheduled(passCount, false);
+	for (;;)
+	{
+		uint32_t next = kInvalidPass;
+		for (uint32_t i = 0; i < passCount && next == kInvalidPass; i++)
+		{
+			if (!mPasses[i].isCulled && !scheduled[i] && inDegree[i] == 0)
+				next = i;
+		}
+		if (next == kInvalidPass) break;
+
+		scheduled[next] = true;
+		mExecutionOrder.push_back(next);
+		for (uint32_t succ : mPasses[next].successors)
+			if (!mPasses[succ].isCulled) inDegree[succ]--;
+	}
+}
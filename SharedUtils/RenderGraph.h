@@ -0,0 +1,123 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** A device-independent description of the data flow between the passes in a RenderingPipeline.
+
+Each pass declares which ResourceManager channels it reads and writes.  Given those declarations
+(in pipeline order), compile() builds a DAG of the dependencies between passes, checks for channels 
+that get read before anyone in the pipeline writes them, and culls passes whose results never reach 
+the pipeline output.  Only full-coverage writes (see addPass()) hide earlier writes of a channel; a pass that
+writes just some texels keeps whoever produced the rest alive.  This class does not touch Falcor or the GPU, 
+so it can be exercised without a device.
+
+Usage:
+     RenderGraph graph;
+     graph.addPass("G-Buffer", {}, { "WorldPosition", "WorldNormal" });
+     graph.addPass("AO", { "WorldPosition", "WorldNormal" }, { "AOOutput" });
+     graph.addPass("Copy", { "AOOutput" }, { ResourceManager::kOutputChannel });
+     graph.compile(ResourceManager::kOutputChannel);
+     for (uint32_t passIdx : graph.getExecutionOrder()) { ... }
+
+Passes that declare no channels at all are "opaque."  We can't reason about them, so they are never 
+culled and are treated as if they read and write every channel (i.e., they act as a barrier).
+*/
+class RenderGraph
+{
+public:
+	static const uint32_t kInvalidPass = 0xFFFFFFFFu;
+
+	RenderGraph() = default;
+
+	// Remove all passes and external channels, and invalidate any prior compilation
+	void clear();
+
+	// Add a pass to the graph.  Passes must be added in the order the pipeline lists them; the returned
+	//    index is simply the order in which this pass was added.  <fullCoverageWrites> lists the written channels 
+	//    where the pass writes every texel (so prior contents, e.g. from a clear, never survive the pass).
+	uint32_t addPass(const std::string& name, const std::vector<std::string>& reads, const std::vector<std::string>& writes,
+		             const std::vector<std::string>& fullCoverageWrites = {});
+
+	// Add a pass that declares no channels (see "opaque" comment, above)
+	uint32_t addOpaquePass(const std::string& name);
+
+	// Channels that are valid before any pass executes (e.g., a loaded environment map).  Reading 
+	//    these without a prior write in the pipeline is not an error.
+	void addExternalChannel(const std::string& channel);
+
+	// Builds the dependency DAG, validates channel usage, and culls passes that don't contribute to 
+	//    the specified output channel.  Returns false if the graph is malformed (which, since passes are 
+	//    added in order, should only happen if the output channel is never written).
+	bool compile(const std::string& outputChannel);
+
+	// Queries on the last compile()
+	bool isCompiled() const                                     { return mIsCompiled; }
+	uint32_t getPassCount() const                               { return uint32_t(mPasses.size()); }
+	const std::string& getPassName(uint32_t passIdx) const      { return mPasses[passIdx].name; }
+	bool isOpaque(uint32_t passIdx) const                       { return mPasses[passIdx].isOpaque; }
+	bool isCulled(uint32_t passIdx) const                       { return mPasses[passIdx].isCulled; }
+	uint32_t getCulledPassCount() const;
+	bool hasOpaquePasses() const;
+
+	// The channels a pass declared when it was added
+	const std::vector<std::string>& getPassReads(uint32_t passIdx) const  { return mPasses[passIdx].reads; }
+	const std::vector<std::string>& getPassWrites(uint32_t passIdx) const { return mPasses[passIdx].writes; }
+	const std::vector<std::string>& getPassFullCoverageWrites(uint32_t passIdx) const { return mPasses[passIdx].fullCoverageWrites; }
+
+	// The passes that should execute this frame, in a dependency-respecting order.  Culled passes are omitted.
+	const std::vector<uint32_t>& getExecutionOrder() const      { return mExecutionOrder; }
+
+	// Passes whose output this pass consumes (producers) and passes that consume this pass' output (consumers).
+	//    These are data-flow edges only:  reads, plus partial writes (which keep the earlier writer's texels).
+	//    Write-after-read and full-coverage write-after-write ordering edges are not included.
+	const std::vector<uint32_t>& getProducers(uint32_t passIdx) const { return mPasses[passIdx].producers; }
+	const std::vector<uint32_t>& getConsumers(uint32_t passIdx) const { return mPasses[passIdx].consumers; }
+
+	// Human-readable descriptions of any read-before-write hazards found by compile()
+	const std::vector<std::string>& getWarnings() const         { return mWarnings; }
+
+protected:
+	struct PassNode
+	{
+		std::string               name;
+		std::vector<std::string>  reads;
+		std::vector<std::string>  writes;
+		std::vector<std::string>  fullCoverageWrites;
+		bool                      isOpaque = false;
+
+		// Filled in by compile()
+		bool                      isCulled = false;
+		std::vector<uint32_t>     producers;       ///< Data-flow edges into this pass
+		std::vector<uint32_t>     consumers;       ///< Data-flow edges out of this pass
+		std::vector<uint32_t>     successors;      ///< All ordering edges out of this pass (incl. consumers)
+	};
+
+	void addEdge(uint32_t from, uint32_t to, bool isDataFlow);
+	void cullUnusedPasses(const std::string& outputChannel);
+	void sortPasses();
+
+	std::vector<PassNode>     mPasses;
+	std::vector<std::string>  mExternalChannels;
+	std::vector<uint32_t>     mExecutionOrder;
+	std::vector<std::string>  mWarnings;
+	bool                      mIsCompiled = false;
+};
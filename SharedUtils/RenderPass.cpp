@@ -18,6 +18,7 @@
 
 #include "RenderPass.h"
 #include "Externals/dear_imgui/imgui.h"
+#include <chrono>
 
 using namespace Falcor;
 
@@ -26,7 +27,12 @@ using namespace Falcor;
 bool ::RenderPass::onInitialize(RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager)
 {
     assert(!mIsInitialized);
+
+	// Tag the channels we request with this pass, so they're only allocated while we're active
+	mpResManager = pResManager;
+	pResManager->beginChannelRequests(this);
 	mIsInitialized = initialize(pRenderContext, pResManager);
+	pResManager->endChannelRequests();
     return mIsInitialized;
 }
 
@@ -50,6 +56,45 @@ void ::RenderPass::onExecute(RenderContext* pRenderContext)
     execute(pRenderContext);
 }
 
+void ::RenderPass::onInitScene(RenderContext* pRenderContext, Scene::SharedPtr pScene)
+{
+	// Inactive passes may never be shown, so wait to do (possibly expensive) scene setup until they're activated
+	if (!isActive())
+	{
+		mpPendingScene = pScene;
+		mHasPendingScene = true;
+		releaseScene();
+		return;
+	}
+
+	mpPendingScene = nullptr;
+	mHasPendingScene = false;
+	bindScene(pRenderContext, pScene);
+}
+
+void ::RenderPass::onPassActivation(RenderContext* pRenderContext)
+{
+	mActivationCount++;
+	if (mpResManager) mpResManager->activateChannelOwner(this);
+
+	// Catch up on any scene loaded while we were inactive
+	if (mHasPendingScene)
+	{
+		Scene::SharedPtr pScene = mpPendingScene;
+		mpPendingScene = nullptr;
+		mHasPendingScene = false;
+		bindScene(pRenderContext, pScene);
+	}
+	activatePass();
+}
+
+void ::RenderPass::onPassDeactivation()
+{
+	if (mActivationCount > 0) mActivationCount--;
+	if (mpResManager) mpResManager->deactivateChannelOwner(this);
+	deactivatePass();
+}
+
 void ::RenderPass::onShutdown()
 {
     // Enforce that onShutdown() is only called once, on successfully initialized passes.
@@ -60,3 +105,26 @@ void ::RenderPass::onShutdown()
     }
     mIsInitialized = false;
 }
+
+// protected
+
+void ::RenderPass::bindScene(RenderContext* pRenderContext, Scene::SharedPtr pScene)
+{
+	auto setupStart = std::chrono::high_resolution_clock::now();
+	initScene(pRenderContext, pScene);
+	mSceneSetupMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - setupStart).count();
+}
+
+void ::RenderPass::declareChannelRead(const std::string& channel)
+{
+    if (std::find(mChannelReads.begin(), mChannelReads.end(), channel) == mChannelReads.end())
+        mChannelReads.push_back(channel);
+}
+
+void ::RenderPass::declareChannelWrite(const std::string& channel, bool writesEveryTexel)
+{
+    if (std::find(mChannelWrites.begin(), mChannelWrites.end(), channel) == mChannelWrites.end())
+        mChannelWrites.push_back(channel);
+    if (writesEveryTexel && std::find(mFullCoverageWrites.begin(), mFullCoverageWrites.end(), channel) == mFullCoverageWrites.end())
+        mFullCoverageWrites.push_back(channel);
+}
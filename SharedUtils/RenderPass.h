@@ -48,6 +48,7 @@ protected:
 	virtual void stateRefreshed() {}
 	virtual void activatePass() {}
 	virtual void deactivatePass() {}
+	virtual void releaseScene() {}   // Called, instead of initScene(), on inactive passes when a new scene loads; drop anything built for the old one
 
 public:
 
@@ -61,6 +62,8 @@ public:
 	virtual bool appliesPostprocess() { return false; }      // Does your pass apply a postprocess?
 	virtual bool usesEnvironmentMap() { return false; }      // Does your pass use an environment map?
 	virtual bool hasAnimation()       { return true;  }      // Controls if "freeze animation" GUI is shown (should generally leave as true)
+	virtual bool isDisplayOnly()      { return false; }      // If true, setting your refresh or rebind flag never invalidates other passes' history
+	virtual bool accumulatesSamples() { return false; }      // Does your pass average results over multiple frames (e.g., for offline rendering)?
 
 
     //
@@ -74,11 +77,13 @@ public:
     */
     bool onInitialize(Falcor::RenderContext* pRenderContext, ResourceManager::SharedPtr pResManager);
 
-    /** Callback on scene initialization.
+    /** Callback on scene initialization.  Passes not currently active in the pipeline just remember the scene, and
+        get it (via initScene()) when next activated, so loading a scene doesn't pay for passes nobody is looking at.
+        Meanwhile, they're asked (via releaseScene()) to let go of whatever they built for the previous scene.
         \param[in] context Provides the current context to initialize resources for your renderer.
         \param[in] scene Provides the newly loaded scene.
     */
-    void onInitScene(Falcor::RenderContext* pRenderContext, Falcor::Scene::SharedPtr pScene) { initScene(pRenderContext, pScene); }
+    void onInitScene(Falcor::RenderContext* pRenderContext, Falcor::Scene::SharedPtr pScene);
 
 	/** Callback for when the pipeline state changes.
 	    \param[in] resourceManager Provides the current resource manager, which has some state changed since the last call.
@@ -121,13 +126,21 @@ public:
     */
     void onShutdown();
 
-	/** Called when this pass is activated via the UI (to add it to your pipeline)
+	/** Called when this pass is activated (added to your pipeline, initially or via the UI).  Channels this pass
+	    requested in initialize() are only allocated while it's active.  If a scene was loaded while the pass
+	    was inactive, it gets passed to initScene() now.
+	    \param[in] context Provides the current context, for any deferred scene initialization.
 	*/
-	void onPassActivation() { activatePass(); }
+	void onPassActivation(Falcor::RenderContext* pRenderContext);
 
-	/** Called when this pass is deactivated via the UI (removed from your pipeline)
+	/** Older form of onPassActivation(), kept so existing callers still compile.  Uses the device's render context.
 	*/
-	void onPassDeactivation() { deactivatePass(); }
+	void onPassActivation() { onPassActivation(Falcor::gpDevice->getRenderContext().get()); }
+
+	/** Called when this pass is deactivated via the UI (removed from your pipeline).  Channels that no active pass
+	    requested get released back to the resource manager's texture pool.
+	*/
+	void onPassDeactivation();
 
     //
     // Public utility functions. These configure the render pass name and UI window.
@@ -173,6 +186,18 @@ public:
     */
     bool isInitialized() const { return mIsInitialized; }
 
+    /** Returns true if this render pass is currently active in the pipeline.
+    */
+    bool isActive() const { return mActivationCount > 0; }
+
+    /** Returns true if a scene was loaded while this pass was inactive, and the pass hasn't seen it yet.
+    */
+    bool hasPendingScene() const { return mHasPendingScene; }
+
+    /** Returns how long (in milliseconds) this pass' initScene() took for the last scene it was given.
+    */
+    float getSceneSetupTime() const { return mSceneSetupMs; }
+
     /** Returns true if refresh flag is set. The flag is automatically reset after execute() is called.
     */
     bool isRefreshFlagSet() const { return mRefreshFlag; }
@@ -185,6 +210,23 @@ public:
     */
     void resetRebindFlag() { mRebindFlag = false; }
 
+    /** Returns the resource manager channels this pass reads, as declared via declareChannelRead().
+    */
+    const std::vector<std::string>& getChannelReads() const { return mChannelReads; }
+
+    /** Returns the resource manager channels this pass writes, as declared via declareChannelWrite().
+    */
+    const std::vector<std::string>& getChannelWrites() const { return mChannelWrites; }
+
+    /** Returns the written channels where execute() overwrites every texel, as declared via declareChannelWrite().
+    */
+    const std::vector<std::string>& getFullCoverageWrites() const { return mFullCoverageWrites; }
+
+    /** Returns true if this pass declared any channel reads or writes.  Passes that declare nothing are
+        treated by the pipeline's RenderGraph as opaque (never culled, and ordered as if they touch everything).
+    */
+    bool declaresChannels() const { return !mChannelReads.empty() || !mChannelWrites.empty(); }
+
 protected:
     /** Constructor.
         \param[in] name The name of the render pass.
@@ -204,6 +246,29 @@ protected:
     */
     void setRebindFlag() { mRebindFlag = true; }
 
+    /** Declare that execute() reads the named resource manager channel.  Call this in initialize() (or whenever
+        your inputs change, followed by setRebindFlag() so the pipeline recompiles its render graph).
+    */
+    void declareChannelRead(const std::string& channel);
+
+    /** Declare that execute() writes the named resource manager channel.  Same rules as declareChannelRead().
+        Set writesEveryTexel if every texel of the channel is written each time the pass executes (e.g., a ray 
+        generation shader that stores a result for every launch index, whatever the ray hits).  The resource 
+        manager then skips clears of that channel, since they'd be overwritten anyway.  Don't claim this if some
+        texels keep their cleared value (e.g., G-buffer channels only written on ray hits).  If execute() sometimes
+        returns without writing (e.g., before its shaders are ready), check that before asking for the cleared
+        channel, and clear it with ResourceManager::clearTexture() on that path, which is never skipped.
+    */
+    void declareChannelWrite(const std::string& channel, bool writesEveryTexel = false);
+
+    /** Calls initScene(), timing how long it takes.
+    */
+    void bindScene(Falcor::RenderContext* pRenderContext, Falcor::Scene::SharedPtr pScene);
+
+    /** Forget all prior channel declarations for this pass.
+    */
+    void clearChannelDeclarations() { mChannelReads.clear(); mChannelWrites.clear(); mFullCoverageWrites.clear(); }
+
 private:
     // Internal state
     std::string mName;                          ///< Name of the render pass.
@@ -212,9 +277,17 @@ private:
     glm::ivec2 mGuiSize = { 250, 160 };         ///< Size in pixels of the UI window in the application window's client area.
 
     bool mIsInitialized = false;                ///< Set to true upon successful intialization.
+    uint32_t mActivationCount = 0;              ///< How many pipeline slots this pass is active in.
+    bool mHasPendingScene = false;              ///< Was a scene loaded while we were inactive?
+    Falcor::Scene::SharedPtr mpPendingScene;    ///< ...if so, that scene.  Passed to initScene() on activation.
+    float mSceneSetupMs = 0.0f;                 ///< Time taken by our last initScene().
     bool mRefreshFlag = true;                   ///< User flag that is automatically reset after execute().
     bool mRebindFlag = true;                    ///< User flag that is manually reset by calling resetRebindFlag().
 
+    std::vector<std::string> mChannelReads;     ///< Channels this pass declares it reads in execute().
+    std::vector<std::string> mChannelWrites;    ///< Channels this pass declares it writes in execute().
+    std::vector<std::string> mFullCoverageWrites; ///< Subset of mChannelWrites where execute() writes every texel.
+
 protected:
     ResourceManager::SharedPtr mpResManager;    ///< All passes will need to talk to the resource manager, so will need to stash a copy
 };
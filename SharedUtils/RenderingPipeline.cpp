@@ -20,11 +20,78 @@
 #include "RenderingPipeline.h"
 #include "Externals/dear_imgui/imgui.h"
 #include "SceneLoaderWrapper.h"
+#include "SceneRegistry.h"
+#include <chrono>
 #include <algorithm>
 
 namespace {
 	const char     *kNullPassDescriptor = "< None >";   ///< Name used in dropdown lists when no pass is selected.
 	const uint32_t  kNullPassId = 0xFFFFFFFFu;          ///< Id used to represent the null pass (using -1).
+	const uint32_t  kResizeDebounceFrames = 4;          ///< Frames the window size must be stable before we resize resources.
+
+	// Pick an image format based on the output filename's extension (defaulting to .png)
+	Bitmap::FileFormat getFileFormatFromExtension(const std::string &filename)
+	{
+		if (hasSuffix(filename, ".exr", false)) return Bitmap::FileFormat::ExrFile;
+		if (hasSuffix(filename, ".pfm", false)) return Bitmap::FileFormat::PfmFile;
+		if (hasSuffix(filename, ".jpg", false)) return Bitmap::FileFormat::JpegFile;
+		if (hasSuffix(filename, ".bmp", false)) return Bitmap::FileFormat::BmpFile;
+		if (hasSuffix(filename, ".tga", false)) return Bitmap::FileFormat::TgaFile;
+		return Bitmap::FileFormat::PngFile;
+	}
+};
+
+/** Lets an OfflineFrameLoop drive a RenderingPipeline.  Each renderSample() executes one full pipeline frame.
+*/
+class PipelineOfflineBackend : public OfflineBackend
+{
+public:
+	PipelineOfflineBackend(RenderingPipeline *pipe) : mpPipe(pipe) {}
+
+	bool loadScene(const std::string& filename) override
+	{
+		RtScene::SharedPtr pScene = ::loadScene(mpPipe->mLastKnownSize, filename.c_str());
+		if (!pScene) return false;
+		mpPipe->onInitNewScene(mpPipe->mpSample->getRenderContext().get(), pScene);
+		return true;
+	}
+
+	bool setCamera(const OfflineRenderSettings& settings) override
+	{
+		Camera::SharedPtr pCamera = mpPipe->mpScene ? mpPipe->mpScene->getActiveCamera() : nullptr;
+		if (!pCamera) return false;
+		pCamera->setPosition(vec3(settings.cameraPosition[0], settings.cameraPosition[1], settings.cameraPosition[2]));
+		pCamera->setTarget(vec3(settings.cameraTarget[0], settings.cameraTarget[1], settings.cameraTarget[2]));
+		pCamera->setUpVector(vec3(settings.cameraUp[0], settings.cameraUp[1], settings.cameraUp[2]));
+		return true;
+	}
+
+	bool beginOutputFrame(uint32_t frameIdx, float animationTime) override
+	{
+		// Move the scene to the right time, and make sure passes throw away any accumulated history
+		mpPipe->mpSample->setCurrentTime(animationTime);
+		mpPipe->mGlobalPipeRefresh = true;
+		return true;
+	}
+
+	bool renderSample(uint32_t frameIdx, uint32_t sampleIdx) override
+	{
+		SampleCallbacks* pSample = mpPipe->mpSample;
+		mpPipe->renderPipelineFrame(pSample, pSample->getRenderContext(), pSample->getCurrentFbo());
+		return true;
+	}
+
+	bool writeOutput(const std::string& filename) override
+	{
+		Texture::SharedPtr pOutput = mpPipe->mpResourceManager->getTexture(mpPipe->mOutputBufferIndex);
+		if (!pOutput) return false;
+		pOutput->captureToFile(0, 0, filename, getFileFormatFromExtension(filename));
+		logInfo("RenderingPipeline: Wrote '" + filename + "'");
+		return true;
+	}
+
+protected:
+	RenderingPipeline *mpPipe;
 };
 
 
@@ -44,20 +111,31 @@ void RenderingPipeline::onLoad(SampleCallbacks* pSample, const RenderContext::Sh
 {
 	// Give the GUI some heft, so we don't need to resize all the time
 	pSample->setDefaultGuiSize(300, 800);
+	mpSample = pSample;
+
+	// When rendering offline, nobody will see a UI, and nobody will switch passes, so don't bother warming them
+	if (mpOfflineLoop)
+	{
+		pSample->toggleUI(false);
+		mWarmAvailPasses = false;
+	}
 
 	// Create our resource manager
 	mpResourceManager = ResourceManager::create(mLastKnownSize.x, mLastKnownSize.y, pSample);
 	mOutputBufferIndex = mpResourceManager->requestTextureResource(ResourceManager::kOutputChannel);
 
-	// Initialize all of the RenderPasses we have available to select for our pipeline
-	for (uint32_t i = 0; i < mAvailPasses.size(); i++)
+	// Initialize only the RenderPasses that start out in our pipeline.  Passes that are merely available
+	//    in the dropdowns get initialized when selected (or warmed up after the first frame is displayed).
+	for (uint32_t i = 0; i < mActivePasses.size(); i++)
 	{
-		if (mAvailPasses[i])
+		if (mActivePasses[i] && !initializePass(pRenderContext.get(), mActivePasses[i]))
 		{
-			// Initialize.  If failure, remove this pass from the list.
-			bool initialized = mAvailPasses[i]->onInitialize(pRenderContext.get(), mpResourceManager);
-			if (!initialized) mAvailPasses[i] = nullptr;
+			mActivePasses[i] = nullptr;
+			mPassId[i] = kNullPassId;
 		}
+
+		// Passes in the pipeline are active (so, e.g., the resource manager allocates the channels they requested)
+		if (mActivePasses[i]) mActivePasses[i]->onPassActivation(pRenderContext.get());
 	}
 
     // If nobody has started inserting passes into our pipeline, set up our GUI so we can start adding passes manually.
@@ -73,15 +151,8 @@ void RenderingPipeline::onLoad(SampleCallbacks* pSample, const RenderContext::Sh
 			createDefaultDropdownGuiForPass(i, mPassSelectors[i]);
     }
 
-	// Create identifiers for profiling.
-    mProfileGPUTimes.resize(mActivePasses.size() * 2);
-    mProfileLastGPUTimes.resize(mActivePasses.size() * 2);
-	for (uint32_t i = 0; i < mActivePasses.size()*2; i++)
-	{
-		char buf[256];
-		sprintf_s(buf, "Pass_%d", i);
-		mProfileNames.push_back( HashedString(std::string(buf)) );
-	}
+	// Create our per-pass profiler.  (Passes get registered with it when the render graph is compiled.)
+	mpProfiler = PassProfiler::create();
 
 	// Create a camera controller
 	mpCameraControl = CameraController::SharedPtr(new FirstPersonCameraController);
@@ -215,6 +286,9 @@ void RenderingPipeline::onGuiRender(SampleCallbacks* pSample, Gui* pGui)
 {
     //Falcor::ProfilerEvent _profileEvent("renderGUI");
 
+	// No UI when rendering offline
+	if (mpOfflineLoop) return;
+
 	pGui->addSeparator();
 
 	// Add a button to allow the user to load a scene
@@ -352,6 +426,93 @@ void RenderingPipeline::onGuiRender(SampleCallbacks* pSample, Gui* pGui)
 			yGuiOffset += mActivePasses[i]->getGuiSize().y; 
 	}
 
+	// Let the user know if some of their passes aren't running because nothing uses their output
+	if (mRenderGraph.getCulledPassCount() > 0)
+	{
+		pGui->addText("");
+		pGui->addText("Skipped passes (output unused):");
+		for (uint32_t i = 0; i < mRenderGraph.getPassCount(); i++)
+		{
+			if (mRenderGraph.isCulled(i))
+				pGui->addText((std::string("     ") + mRenderGraph.getPassName(i)).c_str());
+		}
+	}
+
+	// Allow toggling transient texture aliasing, and show how much memory it saves
+	if (mpResourceManager)
+	{
+		pGui->addText("");
+		bool enableAliasing = mpResourceManager->isTextureAliasingEnabled();
+		if (pGui->addCheckBox("Share memory between transient textures", enableAliasing))
+		{
+			mpResourceManager->setTextureAliasingEnabled(enableAliasing);
+			mPipelineChanged = true;
+		}
+
+		char buf[128];
+		uint64_t unaliasedBytes = mpResourceManager->getUnaliasedTextureBytes();
+		uint64_t savedBytes = unaliasedBytes - mpResourceManager->getAllocatedTextureBytes();
+		sprintf_s(buf, "     Texture memory: %.1f MB (saving %.1f MB)", double(unaliasedBytes - savedBytes) / (1024.0 * 1024.0), double(savedBytes) / (1024.0 * 1024.0));
+		pGui->addText(buf);
+		sprintf_s(buf, "     Channels released (no active pass uses them): %u", mpResourceManager->getReleasedChannelCount());
+		pGui->addText(buf);
+
+		// Allow toggling clear elision (and its debug verification mode)
+		bool enableElision = mpResourceManager->isClearElisionEnabled();
+		if (pGui->addCheckBox("Skip clears of fully overwritten channels", enableElision))
+			mpResourceManager->setClearElisionEnabled(enableElision);
+		bool verifyElision = mpResourceManager->isClearVerificationEnabled();
+		if (pGui->addCheckBox("Verify skipped clears (slow)", verifyElision))
+			mpResourceManager->setClearVerificationEnabled(verifyElision);
+		sprintf_s(buf, "     Clears per frame: %u (skipped %u)", mpResourceManager->getClearsIssued(), mpResourceManager->getClearsElided());
+		pGui->addText(buf);
+	}
+
+	// Show how much scene setup our passes share, and how long the last scene took to load
+	if (mpScene)
+	{
+		char buf[128];
+		SceneRegistry::SharedPtr pRegistry = SceneRegistry::getShared();
+		const SceneRegistry::Stats &sceneStats = pRegistry->getStats();
+		sprintf_s(buf, "Scene renderers: %u live, %u users, %u creations avoided", pRegistry->getLiveRendererCount(), pRegistry->getRendererUserCount(), sceneStats.renderersShared);
+		pGui->addText(buf);
+		sprintf_s(buf, "     Scene load: %.1f ms, pass setup: %.1f ms", sceneStats.lastLoadMs, sceneStats.lastPassSetupMs);
+		pGui->addText(buf);
+		sprintf_s(buf, "     Geometry: %u meshes, %u instances, %.1f MB (%.1f MB flattened)", sceneStats.uniqueMeshes, sceneStats.meshInstances,
+			float(sceneStats.geometryBytes) / 1048576.0f, float(sceneStats.flattenedBytes) / 1048576.0f);
+		pGui->addText(buf);
+		sprintf_s(buf, "     Accel: %.64s", AccelBuildPolicy::toString(sceneStats.accelFlags).c_str());
+		pGui->addText(buf);
+		if (sceneStats.blasCompactedBytes > 0)
+			sprintf_s(buf, "          %u BLAS, %.1f MB (%.1f MB compacted)", sceneStats.blasCount, float(sceneStats.blasBytes) / 1048576.0f, float(sceneStats.blasCompactedBytes) / 1048576.0f);
+		else
+			sprintf_s(buf, "          %u BLAS, %.1f MB (not compacted)", sceneStats.blasCount, float(sceneStats.blasBytes) / 1048576.0f);
+		pGui->addText(buf);
+
+		// Applies to the next scene loaded
+		uint32_t accelMode = uint32_t(pRegistry->getAccelBuildMode());
+		if (pGui->addDropdown("Accel build policy", mAccelModeList, accelMode))
+			pRegistry->setAccelBuildMode(AccelBuildPolicy::Mode(accelMode));
+
+		// Per-pass scene setup costs.  (Inactive passes set up when they're activated, so aren't included above.)
+		uint32_t pendingPasses = 0;
+		for (auto &pPass : mAvailPasses)
+		{
+			if (pPass && pPass->hasPendingScene()) pendingPasses++;
+		}
+		for (auto &pPass : mActivePasses)
+		{
+			if (!pPass) continue;
+			sprintf_s(buf, "          %.64s: %.1f ms", pPass->getName().c_str(), pPass->getSceneSetupTime());
+			pGui->addText(buf);
+		}
+		if (pendingPasses > 0)
+		{
+			sprintf_s(buf, "          (%u inactive pass(es) will set up on activation)", pendingPasses);
+			pGui->addText(buf);
+		}
+	}
+
 	pGui->addText("");
 
 	// Enable an option to enable/disable binding of the camera to a path
@@ -379,6 +540,14 @@ void RenderingPipeline::onGuiRender(SampleCallbacks* pSample, Gui* pGui)
 		}
 	}
 
+    // Allow collecting (and exporting) structured per-pass timings
+    pGui->addText("");
+    pGui->addCheckBox("Collect per-pass timings", mDoProfiling);
+    if (mDoProfiling && mpProfiler)
+    {
+        mpProfiler->renderGui(pGui);
+    }
+
     pGui->addText("");
     pGui->addSeparator();
     pGui->addText(Falcor::gProfileEnabled ? "Press (P):  Hide profiling window" : "Press (P):  Show profiling window");
@@ -572,6 +741,14 @@ void RenderingPipeline::changePass(uint32_t passNum, ::RenderPass::SharedPtr pNe
 	// Set the selected active pass
 	mActivePasses[passNum] = pNewPass;
 
+	// If the newly selected pass has never been used, initialize it now.  If that fails, fall back to a null pass.
+	if (pNewPass && !initializePass(mpSample->getRenderContext().get(), pNewPass))
+	{
+		mActivePasses[passNum] = nullptr;
+		mPassId[passNum] = kNullPassId;
+		pNewPass = nullptr;
+	}
+
 	// Do any activation of the newly selected pass (if it's non-null)
 	if (pNewPass)
 	{
@@ -579,7 +756,7 @@ void RenderingPipeline::changePass(uint32_t passNum, ::RenderPass::SharedPtr pNe
 		pNewPass->onResize(mLastKnownSize.x, mLastKnownSize.y);
 
 		// Tell the pass that it's been activated
-		pNewPass->onPassActivation();
+		pNewPass->onPassActivation(mpSample->getRenderContext().get());
 	}
 
     // (Re)-create a GUI selector for all passes (including any newly added one)
@@ -596,10 +773,73 @@ void RenderingPipeline::changePass(uint32_t passNum, ::RenderPass::SharedPtr pNe
 	mPipelineChanged = true;
 }
 
+bool RenderingPipeline::initializePass(RenderContext* pRenderContext, ::RenderPass::SharedPtr pPass)
+{
+	if (!pPass) return false;
+	if (pPass->isInitialized()) return true;
+
+	// Initialize.  If failure, remove this pass from the list of selectable passes.
+	uint32_t priorChannelCount = mpResourceManager->getTextureCount();
+	if (!pPass->onInitialize(pRenderContext, mpResourceManager))
+	{
+		logWarning(std::string("RenderingPipeline: Failed to initialize pass '") + pPass->getName() + "'; removing it from the pipeline");
+		std::replace(mAvailPasses.begin(), mAvailPasses.end(), pPass, ::RenderPass::SharedPtr(nullptr));
+		return false;
+	}
+
+	// If the resource manager already created its textures, make sure any channels this pass added get created, too
+	if (mpResourceManager->isInitialized() && mpResourceManager->getTextureCount() != priorChannelCount)
+	{
+		mpResourceManager->initializeResources();
+	}
+
+	// If we already loaded a scene, this pass missed hearing about it.  Tell it now.
+	if (mpScene)
+	{
+		pPass->onInitScene(pRenderContext, mpScene);
+	}
+	return true;
+}
+
+void RenderingPipeline::warmNextAvailablePass(RenderContext* pRenderContext)
+{
+	// Falcor's render context isn't thread safe, so rather than warming passes on another thread, we
+	//    amortize the work by initializing at most one pass (i.e., compiling its shaders) per frame.
+	for (; mNextPassToWarm < mAvailPasses.size(); mNextPassToWarm++)
+	{
+		::RenderPass::SharedPtr pPass = mAvailPasses[mNextPassToWarm];
+		if (pPass && !pPass->isInitialized())
+		{
+			// The pass isn't active, so its channel requests don't change any texture the pipeline uses.  Don't let
+			//    the resource manager's dirty flag turn warming into a pipeline change (which would recompile the graph 
+			//    and reset accumulation every frame we warm a pass), unless the pass really replaced a texture we use.
+			bool resourcesWereChanged = mpResourceManager->haveResourcesChanged();
+			std::vector<Texture::SharedPtr> priorTextures(mpResourceManager->getTextureCount());
+			for (uint32_t i = 0; i < uint32_t(priorTextures.size()); i++)
+				priorTextures[i] = mpResourceManager->getTexture(int32_t(i));
+
+			initializePass(pRenderContext, pPass);
+
+			bool texturesReplaced = false;
+			for (uint32_t i = 0; i < uint32_t(priorTextures.size()); i++)
+				texturesReplaced = texturesReplaced || (priorTextures[i] != mpResourceManager->getTexture(int32_t(i)));
+			if (!resourcesWereChanged && !texturesReplaced)
+				mpResourceManager->resetDirtyFlag();
+
+			mNextPassToWarm++;
+			return;
+		}
+	}
+
+	// Everything is initialized; nothing more to do
+	mWarmAvailPasses = false;
+}
+
 void RenderingPipeline::onFirstRun(SampleCallbacks* pSample)
 {
-	// Did the user ask for us to load a scene by default?
-	if (mPipeNeedsDefaultScene)
+	// Did the user ask for us to load a scene by default?  (When rendering offline, a specified scene takes precedence.)
+	bool offlineSceneSpecified = mpOfflineLoop && !mOfflineSettings.sceneFile.empty();
+	if (mPipeNeedsDefaultScene && !offlineSceneSpecified)
 	{
 		RtScene::SharedPtr loadedScene = loadScene(mLastKnownSize, mpResourceManager->getDefaultSceneName().c_str());
 		if (loadedScene) onInitNewScene(pSample->getRenderContext().get(), loadedScene);
@@ -610,6 +850,59 @@ void RenderingPipeline::onFirstRun(SampleCallbacks* pSample)
 
 void RenderingPipeline::onFrameRender(SampleCallbacks* pSample, const RenderContext::SharedPtr &pRenderContext, const Fbo::SharedPtr &pTargetFbo)
 {
+	// When rendering offline, our frame loop decides what happens each frame
+	if (mpOfflineLoop)
+	{
+		stepOfflineRender(pSample);
+		return;
+	}
+
+	renderPipelineFrame(pSample, pRenderContext, pTargetFbo);
+}
+
+void RenderingPipeline::stepOfflineRender(SampleCallbacks* pSample)
+{
+	if (mFirstFrame)
+	{
+		onFirstRun(pSample);
+
+		// Extra samples only help if some pass averages them; otherwise each image would just show its last sample
+		bool hasAccumulator = false;
+		for (auto& pPass : mActivePasses)
+			hasAccumulator = hasAccumulator || (pPass && pPass->accumulatesSamples());
+		if (mOfflineSettings.samplesPerPixel > 1 && !hasAccumulator)
+		{
+			logError("RenderingPipeline: Offline render asked for " + std::to_string(mOfflineSettings.samplesPerPixel) + 
+				" samples per pixel, but no active pass accumulates samples.  Add an accumulation pass or use one sample per pixel.", false);
+			pSample->shutdown();
+			return;
+		}
+	}
+
+	// Render one more sample.  Once we're done (or something failed), exit the application.
+	if (!mpOfflineLoop->step())
+	{
+		if (mpOfflineLoop->hasFailed())
+			logError("RenderingPipeline: Offline render failed.  " + mpOfflineLoop->getError(), false);
+		else
+			logInfo("RenderingPipeline: Offline render complete (" + std::to_string(mpOfflineLoop->getFramesWritten()) + " frames, " +
+				std::to_string(mpOfflineLoop->getSamplesRendered()) + " samples)");
+		pSample->shutdown();
+	}
+}
+
+void RenderingPipeline::renderPipelineFrame(SampleCallbacks* pSample, const RenderContext::SharedPtr &pRenderContext, const Fbo::SharedPtr &pTargetFbo)
+{
+	// Once the window size has settled, resize our resources
+	if (mResizePending && ++mFramesSinceResize >= kResizeDebounceFrames)
+	{
+		mResizePending = false;
+		applyResize(mPendingSize.x, mPendingSize.y);
+	}
+
+	// Once our first frame is on screen, spend a bit of each frame getting unused passes ready
+	if (!mFirstFrame && mWarmAvailPasses) warmNextAvailablePass(pRenderContext.get());
+
 	// Is this the first time we've run onFrameRender()?  If som take care of things that happen on first execution.
 	if (mFirstFrame) onFirstRun(pSample);
 
@@ -634,43 +927,55 @@ void RenderingPipeline::onFrameRender(SampleCallbacks* pSample, const RenderCont
 	bool updatedPipeline = false;
 	if (anyRequestedPipelineChanges())
 	{
+		// Remember which passes ran before, so a graph-only change can refresh just the passes it un-culls
+		mPassRanLastGraph.assign(mActivePasses.size(), false);
+		for (uint32_t passNum : mExecutionOrder)
+			mPassRanLastGraph[passNum] = true;
+
 		// If there's a change, let all the passes know
-		for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
-		{
-			if (mActivePasses[passNum])
-			{
-				mActivePasses[passNum]->onPipelineUpdate( mpResourceManager );
-			}
-		}
+		notifyPassesOfPipelineUpdate();
 
-		// Update our flags
+		// Update our flags and figure out which passes actually need to run
 		updatePipelineRequirementFlags();
-		updatedPipeline = true;
-	}
-
-	// Check if any passes have set their refresh flag
-	if (havePassesSetRefreshFlag() || updatedPipeline || mGlobalPipeRefresh)
-	{
-		// If there's a change, let all the passes know
-		for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
+		compileRenderGraph();
+
+		// Release channels that only passes we just deactivated used.  Then, given the new pass order, let channels with 
+		//    disjoint lifetimes share memory.  If that changed any textures, passes need to know before they grab stale pointers.
+		bool texturesChanged = mpResourceManager->updateChannelResidency();
+		std::vector<const void*> graphPassOwners;
+		for (uint32_t slot : mGraphPassSlot)
+			graphPassOwners.push_back(mActivePasses[slot].get());
+		texturesChanged = mpResourceManager->updateTextureAliasing(mRenderGraph, graphPassOwners) || texturesChanged;
+		if (texturesChanged)
 		{
-			if (mActivePasses[passNum])
-			{
-				mActivePasses[passNum]->onStateRefresh();
-			}
+			notifyPassesOfPipelineUpdate();
+			mpResourceManager->resetDirtyFlag();
 		}
-		mGlobalPipeRefresh = false;
+
+		// Passes don't need to clear channels they completely overwrite
+		mpResourceManager->updateClearElision(mRenderGraph);
+
+		// A display-only pass picking different inputs shouldn't throw away everyone's history (e.g., accumulation)
+		updatedPipeline = mPipelineChanged || texturesChanged;
 	}
 
-    // Execute all of the passes in the current pipeline
-    for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
+	// Pipeline-wide changes refresh every pass.  Otherwise, only passes that set their refresh flag (and
+	//    passes downstream of them) get refreshed.
+	propagateStateRefresh(updatedPipeline || mGlobalPipeRefresh);
+	mGlobalPipeRefresh = false;
+
+    // Execute all of the passes in the current pipeline that contribute to our output
+    if (mDoProfiling) mpProfiler->beginFrame();
+    for (uint32_t step = 0; step < mExecutionOrder.size(); step++)
     {
+        uint32_t passNum = mExecutionOrder[step];
         if (mActivePasses[passNum])
         {
+            if (mDoProfiling) mpProfiler->beginPass(step);
+            mpResourceManager->beginPassExecution(mRenderGraph.getExecutionOrder()[step]);
             if (Falcor::gProfileEnabled)
             {
                 // Insert a per-pass profiling event.  
-                assert(passNum < mProfileNames.size());
                 Falcor::ProfilerEvent _profileEvent(mActivePasses[passNum]->getName().c_str());
                 mActivePasses[passNum]->onExecute(pRenderContext.get());
             }
@@ -678,8 +983,11 @@ void RenderingPipeline::onFrameRender(SampleCallbacks* pSample, const RenderCont
             {
                 mActivePasses[passNum]->onExecute(pRenderContext.get());
             }
+            mpResourceManager->endPassExecution();
+            if (mDoProfiling) mpProfiler->endPass(step);
         }
     }
+    if (mDoProfiling) mpProfiler->endFrame();
 
 	// Now that we're done rendering, grab out output texture and blit it into our target FBO
 	if (pTargetFbo && mpResourceManager->getTexture(mOutputBufferIndex))
@@ -689,6 +997,11 @@ void RenderingPipeline::onFrameRender(SampleCallbacks* pSample, const RenderCont
 
 	// Once we're done rendering, clear the pipeline dirty state.
 	mPipelineChanged = false;
+	mGraphChanged = false;
+	mPassRanLastGraph.clear();
+
+	// Let the resource manager free textures that have sat unused in its pool for a while
+	mpResourceManager->endFrame();
 
 	// Get rid of our default state
 	pRenderContext->popGraphicsState();
@@ -700,17 +1013,40 @@ void RenderingPipeline::onInitNewScene(RenderContext* pRenderContext, Scene::Sha
 	if (pScene) 
 		mpScene = pScene;
 
-	// When a new scene is loaded, we'll tell all our passes about it (not just active passes)
+	// When a new scene is loaded, we'll tell all our initialized passes about it (not just active passes).  Inactive
+	//    passes just remember it until they're activated.  Passes that haven't been initialized yet get the scene 
+	//    in initializePass().
+	auto setupStart = std::chrono::high_resolution_clock::now();
 	for (uint32_t i = 0; i < mAvailPasses.size(); i++)
 	{
-		if (mAvailPasses[i])
+		if (mAvailPasses[i] && mAvailPasses[i]->isInitialized())
 		{
 			mAvailPasses[i]->onInitScene(pRenderContext, pScene);
 		}
 	}
+	SceneRegistry::getShared()->recordScenePassSetup(std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - setupStart).count());
 }
 
 void RenderingPipeline::onResizeSwapChain(SampleCallbacks* pSample, uint32_t width, uint32_t height)
+{
+	// Dragging a window's border sends a flurry of resize events.  Rather than reallocating every resource for each 
+	//    of them, wait until the size has been stable for a few frames.  Before resources exist (or when rendering 
+	//    offline, where nobody is dragging anything), there's nothing to be gained by waiting.
+	bool applyNow = mpOfflineLoop || !mpResourceManager || !mpResourceManager->isInitialized() || 
+		            width <= 0 || height <= 0 || mLastKnownSize.x <= 0 || mLastKnownSize.y <= 0;
+	if (applyNow)
+	{
+		mResizePending = false;
+		applyResize(width, height);
+		return;
+	}
+
+	mPendingSize = uvec2(width, height);
+	mResizePending = true;
+	mFramesSinceResize = 0;
+}
+
+void RenderingPipeline::applyResize(uint32_t width, uint32_t height)
 {
 	// Stash the current size, so if we need it later, we'll have access.
 	mLastKnownSize = uvec2(width, height);
@@ -737,11 +1073,11 @@ void RenderingPipeline::onResizeSwapChain(SampleCallbacks* pSample, uint32_t wid
 
 void RenderingPipeline::onShutdown(SampleCallbacks* pSample)
 {
-	// On program shutdown, call the shutdown callback on all the render passes.
+	// On program shutdown, call the shutdown callback on all the render passes we initialized.
     // We do not have to worry about double-deletion etc. It is currently enforced that a pass is only bound to one pipeline.
 	for (uint32_t i = 0; i < mAvailPasses.size(); i++)
 	{
-		if (mAvailPasses[i])
+		if (mAvailPasses[i] && mAvailPasses[i]->isInitialized())
 		{
 			mAvailPasses[i]->onShutdown();
 		}
@@ -810,7 +1146,11 @@ bool RenderingPipeline::anyRequestedPipelineChanges(void)
 	{
 		if (mActivePasses[passNum] && mActivePasses[passNum]->isRebindFlagSet())
 		{
-			mPipelineChanged = true;
+			// Display-only passes only change which passes the graph runs, not what any pass computes
+			if (mActivePasses[passNum]->isDisplayOnly())
+				mGraphChanged = true;
+			else
+				mPipelineChanged = true;
 			mActivePasses[passNum]->resetRebindFlag();
 		}
 	}
@@ -822,69 +1162,123 @@ bool RenderingPipeline::anyRequestedPipelineChanges(void)
 		mpResourceManager->resetDirtyFlag();
 	}
 
-	return mPipelineChanged;
+	return mPipelineChanged || mGraphChanged;
 }
 
-bool RenderingPipeline::havePassesSetRefreshFlag(void)
+void RenderingPipeline::propagateStateRefresh(bool refreshAll)
 {
-	bool refreshFlag = false;
+	mPassNeedsRefresh.assign(mActivePasses.size(), refreshAll);
+
+	if (!refreshAll)
+	{
+		// Only look at passes that execute; culled passes never get to reset their refresh flags.
+		for (uint32_t graphIdx : mRenderGraph.getExecutionOrder())
+		{
+			uint32_t passNum = mGraphPassSlot[graphIdx];
+			::RenderPass::SharedPtr pPass = mActivePasses[passNum];
+			bool newlyRunning = passNum < mPassRanLastGraph.size() && !mPassRanLastGraph[passNum];
+			if (!pPass || !(pPass->isRefreshFlagSet() || newlyRunning)) continue;
+
+			// The pass that changed always gets refreshed.  Unless it only affects display, so do all its consumers.
+			mPassNeedsRefresh[passNum] = true;
+			if (pPass->isDisplayOnly()) continue;
+
+			mRefreshStack.assign(1, graphIdx);
+			while (!mRefreshStack.empty())
+			{
+				uint32_t curIdx = mRefreshStack.back();
+				mRefreshStack.pop_back();
+				for (uint32_t consumer : mRenderGraph.getConsumers(curIdx))
+				{
+					if (mPassNeedsRefresh[mGraphPassSlot[consumer]]) continue;
+					mPassNeedsRefresh[mGraphPassSlot[consumer]] = true;
+					mRefreshStack.push_back(consumer);
+				}
+			}
+		}
+	}
+
+	// Let the affected passes know
 	for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
 	{
-		if (mActivePasses[passNum] && mActivePasses[passNum]->isRefreshFlagSet())
+		if (mActivePasses[passNum] && mPassNeedsRefresh[passNum])
 		{
-			refreshFlag = true;
+			mActivePasses[passNum]->onStateRefresh();
 		}
 	}
-	return refreshFlag;
 }
 
-void RenderingPipeline::addPipeInstructions(const std::string &str)
+void RenderingPipeline::notifyPassesOfPipelineUpdate(void)
 {
-	mPipeDescription.push_back(str);
+	for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
+	{
+		if (mActivePasses[passNum])
+		{
+			mActivePasses[passNum]->onPipelineUpdate( mpResourceManager );
+		}
+	}
 }
 
-void RenderingPipeline::extractProfilingData(void)
+void RenderingPipeline::compileRenderGraph(void)
 {
-	// This is a pretty ugly method.  It basically undoes Falcor's standard
-	//    profiler output, which is a strigified concatenation of all the data
-	//    we care about.  The 'right' way to deal with this is to update 
-	//    Falcor to provide a more granular way of accessing profile data that
-	//    isn't stringified.  For now, I'll just extract the data from 
-	//    the string.  So, yeah, this is ugly.  And if Falcor changes the profiler,
-	//    this will need updating.
+	mRenderGraph.clear();
+	mGraphPassSlot.clear();
+	mExecutionOrder.clear();
 
-	// Get our Falcor profiler string
-	std::string profileMsg = Profiler::getEventsString();
-    mTmpStr = profileMsg;
+	// Add the active passes to the graph, in pipeline order
+	for (uint32_t passNum = 0; passNum < mActivePasses.size(); passNum++)
+	{
+		::RenderPass::SharedPtr pPass = mActivePasses[passNum];
+		if (!pPass) continue;
+
+		if (pPass->declaresChannels())
+			mRenderGraph.addPass(pPass->getName(), pPass->getChannelReads(), pPass->getChannelWrites(), pPass->getFullCoverageWrites());
+		else
+			mRenderGraph.addOpaquePass(pPass->getName());
+		mGraphPassSlot.push_back(passNum);
+	}
 
-	// Grab all of the lines with profiling data
-	int findPass = 0;
-	int count = 1;
+	// The environment map is loaded by the pipeline, not written by a pass
+	mRenderGraph.addExternalChannel(ResourceManager::kEnvironmentMap);
 
-	size_t endOfLine = profileMsg.find('\n');
-	while (endOfLine != std::string::npos && findPass < mActivePasses.size())
+	// Compile.  Even if this fails, the graph gives a sensible (unculled) execution order.
+	mRenderGraph.compile(ResourceManager::kOutputChannel);
+	for (auto& warning : mRenderGraph.getWarnings())
 	{
-		// Each RenderPass is profiled with the name "Pass_%d" where %d various from 0 to (#passes-1)
-		char buf[128], passName[128];
-		float cpuTime, gpuTime;
-		sprintf_s(buf, "Pass_%d", findPass);
-
-		// See if this line contains the time for the next pass (each line contains: <profileEventName> <cpuTime> <gpuTime>)
-		sscanf( profileMsg.substr(0, endOfLine).c_str(), "%s %f %f ", passName, &cpuTime, &gpuTime );
-		if (!strcmp(buf, passName))
-		{
-			mProfileGPUTimes[findPass++] = gpuTime;	
-		}
+		logWarning(std::string("RenderingPipeline: ") + warning);
+	}
 
-		// Move onto the next line of the string.
-		profileMsg = profileMsg.substr(endOfLine+1);
-		endOfLine = profileMsg.find('\n');
+	// The profiler times passes by their position in the execution order
+	std::vector<std::string> profiledNames;
+	for (uint32_t graphIdx : mRenderGraph.getExecutionOrder())
+	{
+		mExecutionOrder.push_back(mGraphPassSlot[graphIdx]);
+		profiledNames.push_back(mRenderGraph.getPassName(graphIdx));
 	}
+	if (mpProfiler) mpProfiler->setPasses(profiledNames);
 }
 
+void RenderingPipeline::addPipeInstructions(const std::string &str)
+{
+	mPipeDescription.push_back(str);
+}
 
 void RenderingPipeline::run(RenderingPipeline *pipe, SampleConfig &config)
 {
 	pipe->updatePipelineRequirementFlags();
 	Sample::run(config, std::unique_ptr<Renderer>(pipe));
+}
+
+void RenderingPipeline::runOffline(RenderingPipeline *pipe, SampleConfig &config, const OfflineRenderSettings &settings)
+{
+	// This isn't headless:  Falcor creates its device together with a window and swap chain.  Keep the window minimized, 
+	//    and never show a message box (nobody may be around to close it).
+	config.windowDesc.mode = Window::WindowMode::Minimized;
+	config.showMessageBoxOnError = false;
+	config.freezeTimeOnStartup = true;
+
+	pipe->mOfflineSettings = settings;
+	pipe->mpOfflineBackend = std::unique_ptr<OfflineBackend>(new PipelineOfflineBackend(pipe));
+	pipe->mpOfflineLoop = std::unique_ptr<OfflineFrameLoop>(new OfflineFrameLoop(settings, pipe->mpOfflineBackend.get()));
+	run(pipe, config);
 }
\ No newline at end of file
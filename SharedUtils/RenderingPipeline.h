@@ -20,9 +20,14 @@
 #include "Falcor.h"
 #include "RenderPass.h"
 #include "ResourceManager.h"
+#include "RenderGraph.h"
+#include "PassProfiler.h"
+#include "OfflineFrameLoop.h"
 
 class RenderingPipeline : public Renderer, inherit_shared_from_this<Renderer, RenderingPipeline>
 {
+	friend class PipelineOfflineBackend;
+
 public:
     using SharedPtr = std::shared_ptr<RenderingPipeline>;
  
@@ -53,6 +58,14 @@ public:
 	*/
 	static void run(RenderingPipeline *pipe, SampleConfig &config);
 
+	/** Run the pipeline as a non-interactive batch render:  load a scene, render the requested number of frames 
+	    (accumulating samplesPerPixel pipeline executions each), write each to disk, then exit.  This is not headless; 
+	    Falcor still creates a window (kept minimized) and swap chain, but no GUI is drawn.  Using more than one sample 
+	    per pixel requires an active pass that accumulates samples (see RenderPass::accumulatesSamples()); without one,
+	    the render fails.  See parseOfflineCommandLine() for a way to fill in <settings> from the command line.
+	*/
+	static void runOffline(RenderingPipeline *pipe, SampleConfig &config, const OfflineRenderSettings &settings);
+
 	// Overloaded methods from MyRenderer
 	virtual void onLoad(SampleCallbacks* pSample, const RenderContext::SharedPtr &pRenderContext) override;
 	virtual void onFrameRender(SampleCallbacks* pSample, const RenderContext::SharedPtr &pRenderContext, const Fbo::SharedPtr &pTargetFbo) override;
@@ -86,6 +99,12 @@ private:
 	// On the first execution of onFrameRender(), we're calling this
 	void onFirstRun(SampleCallbacks* pSample);
 
+	// Executes all the passes in the pipeline (i.e., what onFrameRender() does when rendering interactively)
+	void renderPipelineFrame(SampleCallbacks* pSample, const RenderContext::SharedPtr &pRenderContext, const Fbo::SharedPtr &pTargetFbo);
+
+	// When rendering offline, advances our OfflineFrameLoop by one sample per frame
+	void stepOfflineRender(SampleCallbacks* pSample);
+
 	// Want to remove a pass from the list?  
 	void removePassFromPipeline(uint32_t passNum);
 
@@ -95,6 +114,13 @@ private:
 	// Do what needs to be done to change the render pass executed in order <passNum> to use the pass in <pNewPass>.
 	void changePass(uint32_t passNum, ::RenderPass::SharedPtr pNewPass);
 
+	// Initializes a pass (if not already initialized) and gives it the current scene.  On failure, the pass is
+	//    removed from mAvailPasses and false is returned.
+	bool initializePass(RenderContext* pRenderContext, ::RenderPass::SharedPtr pPass);
+
+	// After the first frame, initialize (at most) one not-yet-used available pass per frame, so switching to it later is fast
+	void warmNextAvailablePass(RenderContext* pRenderContext);
+
 	// Creates a UI dropdown for inserting/changing the pass at order <passNum> in the list of active passes.
 	void createDropdownGuiForPass(uint32_t passNum, Gui::DropdownList& outputList);
 	void createDefaultDropdownGuiForPass(uint32_t passNum, Gui::DropdownList& outputList);
@@ -105,14 +131,21 @@ private:
 	// Check if any of the active passes have requested a pipeline change; also resets pass rebind flags.
 	bool anyRequestedPipelineChanges(void);
 
-	// Check if any passes have set a refresh flag (i.e., settings changed; temporal history should be invalidated)
-	bool havePassesSetRefreshFlag(void);
+	// Calls onStateRefresh() on passes whose temporal history should be invalidated:  either all passes, or only 
+	//    those that set their refresh flag (or just stopped being culled) plus everything downstream of them in the render graph.
+	void propagateStateRefresh(bool refreshAll);
+
+	// Resizes the resource manager and active passes to the specified swap chain size
+	void applyResize(uint32_t width, uint32_t height);
 
 	// Update the mPipeRequires* member variables
 	void updatePipelineRequirementFlags(void);
 
-	// Extract profiling data
-	void extractProfilingData(void);
+	// Call onPipelineUpdate() on all active passes
+	void notifyPassesOfPipelineUpdate(void);
+
+	// Rebuild mRenderGraph from the channel declarations of the active passes and update mExecutionOrder
+	void compileRenderGraph(void);
 
 	enum UIOptions { CanRemove = 0x1u, CanAddAfter = 0x2u };
 
@@ -123,24 +156,39 @@ private:
 	std::vector< uint32_t > mPassId;                        ///< Stores UI variables for currently selected passes.
 	std::vector< bool > mEnablePassGui;                     ///< Stores whether the UI window for each pass is enabled
 	std::vector< int32_t > mEnableAddRemove;                ///< Stores whether the UI allows adding after this pass or removing this pass
-	uvec2 mLastKnownSize = uvec2(0);                        ///< Last known size sent to onResizeSwapChain().
+	RenderGraph mRenderGraph;                               ///< Dependency graph between the active passes (rebuilt when the pipeline changes)
+	std::vector< uint32_t > mGraphPassSlot;                 ///< Maps RenderGraph pass indices to indices in mActivePasses
+	std::vector< uint32_t > mExecutionOrder;                ///< Indices into mActivePasses, in the order they should execute (culled passes omitted)
+	std::vector< bool > mPassNeedsRefresh;                  ///< Scratch space for propagateStateRefresh() (indexed like mActivePasses)
+	std::vector< uint32_t > mRefreshStack;                  ///< Scratch space for propagateStateRefresh() (RenderGraph pass indices)
+	std::vector< bool > mPassRanLastGraph;                  ///< During a graph recompile, which mActivePasses executed before it (empty otherwise)
+	uvec2 mLastKnownSize = uvec2(0);                        ///< Last swap chain size our resources were resized to.
+	uvec2 mPendingSize = uvec2(0);                          ///< Newest size sent to onResizeSwapChain(), applied once it stops changing
+	bool mResizePending = false;                            ///< Is mPendingSize waiting to be applied?
+	uint32_t mFramesSinceResize = 0;                        ///< Frames since the last resize event (while mResizePending)
 	bool mPipelineChanged = true;                           ///< A flag to keep track of pipeline changes
+	bool mGraphChanged = false;                             ///< A display-only pass re-declared its channels (recompile the graph, but don't refresh every pass)
 	bool mIsInitialized = false;
-	bool mDoProfiling = false;
-    bool mProfileToggle = false;
+	bool mDoProfiling = false;                              ///< Record per-pass timings with mpProfiler?
 	bool mFirstFrame = true;
+	bool mWarmAvailPasses = true;                           ///< Initialize inactive passes, one per frame, after the first frame is displayed?
+	uint32_t mNextPassToWarm = 0;                           ///< Index in mAvailPasses of the next pass to consider warming
 	bool mUseSceneCameraPath = false;
 	bool mFreezeTime = true;
 	bool mGlobalPipeRefresh = false;
 	ResourceManager::SharedPtr mpResourceManager;
+	SampleCallbacks* mpSample = nullptr;                    ///< Stashed in onLoad(), so we can get a render context when lazily initializing passes
 	int32_t mOutputBufferIndex = 0;
 	Scene::SharedPtr mpScene = nullptr;                     ///< Stash a copy of our scene
 	CameraController::SharedPtr mpCameraControl;
 	GraphicsState::SharedPtr mpDefaultGfxState;
 	std::vector< std::string > mPipeDescription;            ///< Can store a description of the pipeline for display in the UI
-	std::vector< HashedString > mProfileNames;
-	std::vector< double > mProfileGPUTimes;
-    std::vector< double > mProfileLastGPUTimes;
+	PassProfiler::SharedPtr mpProfiler;                     ///< Per-pass CPU/GPU timings (indexed by position in mExecutionOrder)
+
+	// State for offline (batch) rendering.  mpOfflineLoop is null when running interactively.
+	OfflineRenderSettings mOfflineSettings;
+	std::unique_ptr<OfflineBackend> mpOfflineBackend;
+	std::unique_ptr<OfflineFrameLoop> mpOfflineLoop;
 
 	// Are we storing an environment map?
 	Gui::DropdownList mEnvMapSelector;
@@ -168,5 +216,6 @@ private:
 	float             mMinTArray[8] = { 0.1f, 0.01f, 0.001f, 1e-4f, 1e-5f, 1e-6f, 1e-7f, 0.0f };
 	uint32_t          mMinTSelection = 3;
 
-    std::string mTmpStr = "";
+	// A dropdown selecting how acceleration structures get built (indexed by AccelBuildPolicy::Mode)
+	Gui::DropdownList mAccelModeList = { { 0, "Automatic" }, { 1, "Prefer fast trace" }, { 2, "Prefer fast build" } };
 };
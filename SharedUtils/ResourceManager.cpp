@@ -17,16 +17,27 @@
 **********************************************************************************************************************/
 
 #include "ResourceManager.h"
+#include "TransientAliasPlanner.h"
+#include <algorithm>
+#include <cstring>
 
 // The fixed resource name of our output channel
 const std::string ResourceManager::kOutputChannel  = "PipelineOutput";
 const std::string ResourceManager::kEnvironmentMap = "EnvironmentMap";
+const ChannelId   ResourceManager::kOutputChannelId("PipelineOutput");
+const ChannelId   ResourceManager::kEnvironmentMapId("EnvironmentMap");
 
 ResourceManager::SharedPtr ResourceManager::create(uint32_t width, uint32_t height, SampleCallbacks *callbacks)
 {
 	return SharedPtr(new ResourceManager(width, height, callbacks));
 }
 
+ResourceManager::ResourceManager(uint32_t width, uint32_t height, SampleCallbacks *callbacks) 
+	: mWidth(width), mHeight(height), mpAppCallbacks(callbacks),
+	  mTexturePool([](const TexturePoolKey &key) { return Texture::create2D(key.width, key.height, key.format, 1u, 1u, nullptr, key.bindFlags); })
+{
+}
+
 void ResourceManager::resize(uint32_t width, uint32_t height)
 {
 	// Don't spend time resizing resources if we didn't change resolutions!
@@ -44,14 +55,16 @@ void ResourceManager::resize(uint32_t width, uint32_t height)
 		initializeResources();
 
 	// Resize our resources that dynamically resize.
-	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
-	{
-		// Only resize textures that are defined to be screensize
-		if (mTextureSizes[i] != ivec2(-1, -1)) continue;
+	auto priorStats = mTexturePool.getStats();
+	allocateTextures(true);
+	for (int32_t i = 0; i < int32_t(mHistories.size()); i++)
+		allocateHistory(i);
 
-		// Recreate our texture with the new size
-		mTextures[i] = Texture::create2D(mWidth, mHeight, mTextureFormat[i], 1u, 1u, nullptr, mTextureFlags[i]);
-	}
+	// Report how much work the resize actually took
+	uint64_t allocated = mTexturePool.getStats().allocations - priorStats.allocations;
+	uint64_t reused = mTexturePool.getStats().reuses - priorStats.reuses;
+	logInfo(std::string("ResourceManager: Resized to ") + std::to_string(mWidth) + "x" + std::to_string(mHeight) + "; " +
+		std::to_string(allocated) + " texture(s) allocated, " + std::to_string(reused) + " reused from pool");
 
 	mUpdatedFlag = true;
 }
@@ -59,21 +72,360 @@ void ResourceManager::resize(uint32_t width, uint32_t height)
 void ResourceManager::initializeResources()
 {
 	// Create all textures that have not been allocated otherwise.
+	allocateTextures(false);
+	for (int32_t i = 0; i < int32_t(mHistories.size()); i++)
+	{
+		if (!mHistories[i].getCurrent()) allocateHistory(i);
+	}
+
+	mIsInitialized = true;
+	mUpdatedFlag = true;
+}
+
+void ResourceManager::allocateTextures(bool recreateScreenSized)
+{
+	std::vector<Texture::SharedPtr> previous = getPoolOwnedTextures();
+	std::vector<bool> needed = getNeededTextures();
+	mResidencyDirty = false;    // Any pending releases happen now
+
+	// Drop textures we're about to replace:  those of aliased channels (they'll get their owner's), if resizing, screen-sized 
+	//    ones, and those no active pass needs anymore
 	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
 	{
+		bool isScreenSized = (mTextureSizes[i] == ivec2(-1, -1));
+		bool isReleased = !needed[i] && !mTextureExternal[i];
+		if (mTextureAlias[i] != i || isReleased || (recreateScreenSized && isScreenSized && !mTextureExternal[i]))
+			mTextures[i] = nullptr;
+	}
+
+	// Put those back in the pool before allocating, so channels that changed owners can pick up the memory just freed
+	recycleTextures(previous);
+
+	// Create textures for channels that own their memory and are needed, but don't have a texture (yet)
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (mTextureAlias[i] != i || mTextures[i] || !needed[i]) continue;
+
 		// Either use explicitly specified texture sizes, or if no size specified texture is assumed to be full-screen
 		uint32_t texWidth = mTextureSizes[i].x <= 0 ? mWidth : mTextureSizes[i].x;
 		uint32_t texHeight = mTextureSizes[i].y <= 0 ? mHeight : mTextureSizes[i].y;
+		mTextures[i] = acquirePooledTexture(texWidth, texHeight, mTextureFormat[i], mTextureFlags[i]);
+	}
 
-		// Create the resource (unless it already exists, because a pass created it and passed it in to be managed)
-		if (!mTextures[i])
-			mTextures[i] = Texture::create2D(texWidth, texHeight, mTextureFormat[i], 1u, 1u, nullptr, mTextureFlags[i]);
+	// Aliased channels simply share their owner's texture (while someone needs them)
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (mTextureAlias[i] != i) 
+			mTextures[i] = isChannelResident(i) ? mTextures[mTextureAlias[i]] : nullptr;
 	}
+}
 
-	mIsInitialized = true;
+std::vector<bool> ResourceManager::getNeededTextures() const
+{
+	std::vector<bool> needed(mTextures.size(), false);
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (isChannelResident(i)) needed[mTextureAlias[i]] = true;
+	}
+	return needed;
+}
+
+void ResourceManager::noteChannelRequest(int32_t index)
+{
+	bool wasResident = isChannelResident(index);
+	if (!mpRequestingOwner)
+		mChannelPinned[index] = true;
+	else if (std::find(mChannelOwners[index].begin(), mChannelOwners[index].end(), mpRequestingOwner) == mChannelOwners[index].end())
+		mChannelOwners[index].push_back(mpRequestingOwner);
+
+	// A previously released channel that's needed again gets its texture back now
+	if (mIsInitialized && !wasResident && isChannelResident(index))
+	{
+		allocateTextures(false);
+		mUpdatedFlag = true;
+	}
+}
+
+void ResourceManager::activateChannelOwner(const void *pOwner)
+{
+	if (mOwnerActivations[pOwner]++ > 0) return;
+
+	// Bring back (from the pool, if they're still there) textures for channels this requester needs, so they're
+	//    valid before it next executes.  This also applies any pending releases.
+	mResidencyDirty = true;
+	updateChannelResidency();
+}
+
+void ResourceManager::deactivateChannelOwner(const void *pOwner)
+{
+	auto entry = mOwnerActivations.find(pOwner);
+	if (entry == mOwnerActivations.end() || --entry->second > 0) return;
+	mOwnerActivations.erase(entry);
+
+	// Wait to release textures until updateChannelResidency(), since a replacement pass (e.g., in changePass()) 
+	//    probably wants many of the same channels
+	mResidencyDirty = true;
+}
+
+bool ResourceManager::updateChannelResidency()
+{
+	if (!mResidencyDirty || !mIsInitialized) return false;
+	mResidencyDirty = false;
+
+	std::vector<Texture::SharedPtr> prior = mTextures;
+	allocateTextures(false);
+	if (prior == mTextures) return false;
+
+	logInfo(std::string("ResourceManager: ") + std::to_string(getReleasedChannelCount()) + " channel(s) released (not used by any active pass); " +
+		std::to_string(getAllocatedTextureBytes() / (1024 * 1024)) + " MB of channel textures allocated");
+	mUpdatedFlag = true;
+	return true;
+}
+
+uint32_t ResourceManager::getChannelRefCount(int32_t channelIdx) const
+{
+	if (channelIdx < 0 || channelIdx >= int32_t(mTextures.size())) return 0;
+
+	uint32_t refs = (mChannelPinned[channelIdx] || mTextureExternal[channelIdx]) ? 1 : 0;
+	for (const void *pOwner : mChannelOwners[channelIdx])
+	{
+		if (mOwnerActivations.count(pOwner) > 0) refs++;
+	}
+	return refs;
+}
+
+uint32_t ResourceManager::getReleasedChannelCount() const
+{
+	uint32_t count = 0;
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (!isChannelResident(i)) count++;
+	}
+	return count;
+}
+
+int32_t ResourceManager::requestHistoryResource(const std::string &historyName, ResourceFormat format, Resource::BindFlags usageFlags)
+{
+	int32_t existingIndex = getHistoryIndex(historyName);
+	if (existingIndex >= 0)
+	{
+		// Like channels, a history can be shared, but only if everyone agrees what it contains
+		if (mHistoryFormat[existingIndex] != format || mHistoryFlags[existingIndex] != usageFlags)
+		{
+			logWarning(std::string("ResourceManager: History '") + historyName + "' already exists with a different format or usage");
+			return -1;
+		}
+		return existingIndex;
+	}
+
+	mHistories.push_back(PingPongResource<Texture::SharedPtr>());
+	mHistoryNames.push_back(historyName);
+	mHistoryFormat.push_back(format);
+	mHistoryFlags.push_back(usageFlags);
+
+	int32_t historyIdx = int32_t(mHistories.size()) - 1;
+	if (mIsInitialized) allocateHistory(historyIdx);
+	return historyIdx;
+}
+
+int32_t ResourceManager::getHistoryIndex(const std::string &historyName) const
+{
+	for (int32_t i = 0; i < int32_t(mHistoryNames.size()); i++)
+	{
+		if (mHistoryNames[i] == historyName) return i;
+	}
+	return -1;
+}
+
+void ResourceManager::allocateHistory(int32_t historyIdx)
+{
+	PingPongResource<Texture::SharedPtr> &history = mHistories[historyIdx];
+
+	// Hand our old textures back before asking for new ones, in case a prior size can be reused
+	Texture::SharedPtr first = history.getCurrent(), second = history.getPrevious();
+	releasePooledTexture(first);
+	releasePooledTexture(second);
+
+	history.reset(acquirePooledTexture(mWidth, mHeight, mHistoryFormat[historyIdx], mHistoryFlags[historyIdx]),
+		          acquirePooledTexture(mWidth, mHeight, mHistoryFormat[historyIdx], mHistoryFlags[historyIdx]));
 	mUpdatedFlag = true;
 }
 
+Texture::SharedPtr ResourceManager::getHistoryRead(int32_t historyIdx)
+{
+	if (historyIdx < 0 || historyIdx >= int32_t(mHistories.size())) return nullptr;
+	return mHistories[historyIdx].getPrevious();
+}
+
+Texture::SharedPtr ResourceManager::getHistoryWrite(int32_t historyIdx)
+{
+	if (historyIdx < 0 || historyIdx >= int32_t(mHistories.size())) return nullptr;
+	mHistories[historyIdx].markWritten();
+	return mHistories[historyIdx].getCurrent();
+}
+
+uint32_t ResourceManager::getHistoryWriteSlot(int32_t historyIdx) const
+{
+	if (historyIdx < 0 || historyIdx >= int32_t(mHistories.size())) return 0;
+	return mHistories[historyIdx].getCurrentSlot();
+}
+
+bool ResourceManager::hasValidHistory(int32_t historyIdx) const
+{
+	if (historyIdx < 0 || historyIdx >= int32_t(mHistories.size())) return false;
+	return mHistories[historyIdx].hasValidHistory();
+}
+
+void ResourceManager::endFrame()
+{
+	for (auto &history : mHistories)
+		history.endFrame();
+	mTexturePool.endFrame();
+
+	mLastFrameClearsIssued = mClearsIssued;
+	mLastFrameClearsElided = mClearsElided;
+	mClearsIssued = mClearsElided = 0;
+}
+
+std::vector<Texture::SharedPtr> ResourceManager::getPoolOwnedTextures() const
+{
+	std::vector<Texture::SharedPtr> textures(mTextures.size());
+	for (size_t i = 0; i < mTextures.size(); i++)
+	{
+		if (!mTextureExternal[i]) textures[i] = mTextures[i];
+	}
+	return textures;
+}
+
+void ResourceManager::recycleTextures(const std::vector<Texture::SharedPtr> &previous)
+{
+	for (size_t i = 0; i < previous.size(); i++)
+	{
+		if (!previous[i]) continue;
+
+		// Aliased channels show up multiple times; only release each texture once
+		bool seenBefore = std::find(previous.begin(), previous.begin() + i, previous[i]) != previous.begin() + i;
+		bool stillUsed = std::find(mTextures.begin(), mTextures.end(), previous[i]) != mTextures.end();
+		if (seenBefore || stillUsed) continue;
+
+		Texture::SharedPtr tex = previous[i];
+		releasePooledTexture(tex);
+	}
+}
+
+Texture::SharedPtr ResourceManager::acquirePooledTexture(uint32_t width, uint32_t height, ResourceFormat format, Resource::BindFlags usageFlags)
+{
+	return mTexturePool.acquire({ format, usageFlags, width, height });
+}
+
+void ResourceManager::releasePooledTexture(Texture::SharedPtr &tex)
+{
+	if (!tex) return;
+	mTexturePool.release({ tex->getFormat(), tex->getBindFlags(), tex->getWidth(), tex->getHeight() }, tex);
+	tex = nullptr;
+}
+
+bool ResourceManager::updateTextureAliasing(const RenderGraph& graph, const std::vector<const void*>& graphPassOwners)
+{
+	// Describe all our channels to the planner
+	TransientAliasPlanner planner;
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		TransientAliasPlanner::AliasKey key;
+		key.format = uint32_t(mTextureFormat[i]);
+		key.bindFlags = uint32_t(mTextureFlags[i]);
+		key.width = mTextureSizes[i].x;
+		key.height = mTextureSizes[i].y;
+
+		// Our output gets displayed after all passes run, and the environment map (and any other textures 
+		//    passed in by the user) have contents we didn't create.  None of these can be aliased.
+		bool isPinned = mTextureExternal[i] || mTextureNames[i] == kOutputChannel || mTextureNames[i] == kEnvironmentMap;
+		planner.addResource(mTextureNames[i], key, getTextureBytes(i), isPinned);
+	}
+
+	// Opaque passes didn't declare what they touch, so assume they read and write every channel they requested (plus 
+	//    any requested outside a pass).  If we don't know who an opaque pass is, we can't reason about lifetimes at all.
+	const std::vector<uint32_t>& order = graph.getExecutionOrder();
+	bool canAlias = mAliasingEnabled;
+	for (uint32_t step = 0; step < order.size() && canAlias; step++)
+	{
+		if (graph.isOpaque(order[step]))
+			canAlias = order[step] < graphPassOwners.size() && graphPassOwners[order[step]] != nullptr;
+	}
+
+	if (canAlias)
+	{
+		for (uint32_t step = 0; step < order.size(); step++)
+		{
+			if (graph.isOpaque(order[step]))
+			{
+				const void *pOwner = graphPassOwners[order[step]];
+				for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+				{
+					bool requested = mChannelPinned[i] || std::find(mChannelOwners[i].begin(), mChannelOwners[i].end(), pOwner) != mChannelOwners[i].end();
+					if (!requested) continue;
+					planner.addUse(mTextureNames[i], step, false);
+					planner.addUse(mTextureNames[i], step, true);
+				}
+				continue;
+			}
+
+			for (auto& channel : graph.getPassReads(order[step]))
+				planner.addUse(channel, step, false);
+			for (auto& channel : graph.getPassWrites(order[step]))
+				planner.addUse(channel, step, true);
+		}
+		planner.plan();
+	}
+
+	// Update our alias table.  Channels that previously borrowed another channel's texture need to drop it.
+	bool aliasesChanged = false;
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		int32_t newAlias = int32_t(planner.getAliasTarget(uint32_t(i)));
+		if (newAlias == mTextureAlias[i]) continue;
+
+		if (mTextureAlias[i] != i) mTextures[i] = nullptr;
+		mTextureAlias[i] = newAlias;
+		aliasesChanged = true;
+	}
+	if (!aliasesChanged) return false;
+
+	if (mIsInitialized) allocateTextures(false);
+	mUpdatedFlag = true;
+
+	// Report how much memory this pipeline configuration saves
+	logInfo(std::string("ResourceManager: Transient texture aliasing saves ") + std::to_string(planner.getBytesSaved() / (1024 * 1024)) + 
+		" MB (" + std::to_string(planner.getUnaliasedBytes() / (1024 * 1024)) + " MB -> " + std::to_string(planner.getAliasedBytes() / (1024 * 1024)) + " MB)");
+	return true;
+}
+
+uint64_t ResourceManager::getTextureBytes(int32_t index) const
+{
+	uint64_t texWidth = mTextureSizes[index].x <= 0 ? mWidth : mTextureSizes[index].x;
+	uint64_t texHeight = mTextureSizes[index].y <= 0 ? mHeight : mTextureSizes[index].y;
+	return texWidth * texHeight * getFormatBytesPerBlock(mTextureFormat[index]);
+}
+
+uint64_t ResourceManager::getUnaliasedTextureBytes() const
+{
+	uint64_t bytes = 0;
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+		bytes += getTextureBytes(i);
+	return bytes;
+}
+
+uint64_t ResourceManager::getAllocatedTextureBytes() const
+{
+	std::vector<bool> needed = getNeededTextures();
+	uint64_t bytes = 0;
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (mTextureAlias[i] == i && needed[i]) bytes += getTextureBytes(i);
+	}
+	return bytes;
+}
+
 bool ResourceManager::updateEnvironmentMap(const std::string &filename)
 {
 	// Pass in a NULL file?  Change to our default texture
@@ -132,22 +484,24 @@ int32_t ResourceManager::manageTextureResource(const std::string &channelName, T
 	int32_t existingIndex = getTextureIndex(channelName);
 
 	// No existing resource with that name.  Create one.
-	if (existingIndex <= 0)
+	if (existingIndex < 0)
 	{
-		existingIndex = int32_t(mTextures.size());
-		mTextures.push_back(nullptr);
-		mTextureSizes.push_back(ivec2(-1, -1));
-		mTextureNames.push_back(channelName);
-		mTextureFlags.push_back(kDefaultFlags);
-		mTextureFormat.push_back(sharedTex->getFormat());
+		existingIndex = addChannel(channelName, sharedTex->getFormat(), kDefaultFlags, ivec2(-1, -1), true);
 	}
 
+	// We don't own this texture's memory, so nobody else can share it
+	std::vector<Texture::SharedPtr> previous = getPoolOwnedTextures();
+	unaliasTexture(existingIndex);
+	mTextureExternal[existingIndex] = true;
+
 	// Override requested resolution and format based on the incoming texture
 	mTextureFormat[existingIndex] = sharedTex->getFormat();
 	mTextureSizes[existingIndex] = ivec2(sharedTex->getWidth(), sharedTex->getHeight());
 
-	// Store our texture pointer
+	// Store our texture pointer (and reallocate any channels that were sharing this one's old texture)
 	mTextures[existingIndex] = sharedTex;
+	if (mIsInitialized) allocateTextures(false);
+	recycleTextures(previous);
 
 	// Since we passed in an existing texture, it has the usage flags it was created with. 
 	mTextureFlags[existingIndex] = kDefaultFlags;
@@ -159,11 +513,49 @@ int32_t ResourceManager::manageTextureResource(const std::string &channelName, T
 
 int32_t ResourceManager::getTextureIndex(const std::string &channelName) const
 {
+	// Hash lookup first.  If the name doesn't match (i.e., a hash collision), fall back to a linear search.
+	auto entry = mChannelLookup.find(ChannelId::hash(channelName.c_str()));
+	if (entry != mChannelLookup.end() && mTextureNames[entry->second] == channelName)
+		return entry->second;
+	if (entry == mChannelLookup.end())
+		return -1;
+
 	auto item = std::find(mTextureNames.begin(), mTextureNames.end(), channelName);
 	int32_t channelIdx = int32_t(item - mTextureNames.begin());
 	return (channelIdx >= mTextureNames.size()) ? -1 : channelIdx;
 }
 
+int32_t ResourceManager::getTextureIndex(const ChannelId &channelId) const
+{
+	auto entry = mChannelLookup.find(channelId.getHash());
+	return (entry == mChannelLookup.end()) ? -1 : entry->second;
+}
+
+int32_t ResourceManager::addChannel(const std::string &channelName, ResourceFormat channelFormat, Resource::BindFlags usageFlags, ivec2 channelSize, bool isExternal)
+{
+	int32_t channelIdx = int32_t(mTextures.size());
+	mTextures.push_back(nullptr);    // We'll actually create the resource in initializeResources()
+	mTextureSizes.push_back(channelSize);
+	mTextureNames.push_back(channelName);
+	mTextureFlags.push_back(usageFlags);
+	mTextureFormat.push_back(channelFormat);
+	mTextureAlias.push_back(channelIdx);
+	mTextureExternal.push_back(isExternal);
+	mTextureCoverageFailed.push_back(false);
+	mChannelOwners.push_back({});
+	mChannelPinned.push_back(false);
+
+	// Register the name's hash.  Two names with the same hash is (astronomically) unlikely, but if it happens,
+	//    the first channel keeps the hash; the second can still be found by name.
+	uint64_t hash = ChannelId::hash(channelName.c_str());
+	if (!mChannelLookup.insert({ hash, channelIdx }).second)
+	{
+		logError("ResourceManager: Channel '" + channelName + "' has the same hash as '" + mTextureNames[mChannelLookup[hash]] + 
+			"'.  Look it up by name or index.", false);
+	}
+	return channelIdx;
+}
+
 std::string ResourceManager::getTextureName(int32_t channelIdx)
 {
 	if (channelIdx < 0 || channelIdx >= mTextureNames.size()) 
@@ -185,11 +577,7 @@ Texture::SharedPtr ResourceManager::getTexture(const std::string &channelName)
 
 Texture::SharedPtr ResourceManager::getClearedTexture(const std::string &channelName, vec4 &clearColor)
 {
-	Texture::SharedPtr channel = getTexture(channelName);
-	if (!channel) return nullptr;
-
-	mpAppCallbacks->getRenderContext()->clearUAV(channel->getUAV().get(), clearColor);
-	return channel;
+	return getClearedTexture(getTextureIndex(channelName), clearColor);
 }
 
 Texture::SharedPtr ResourceManager::getClearedTexture(int32_t channelIdx, vec4 &clearColor)
@@ -197,10 +585,102 @@ Texture::SharedPtr ResourceManager::getClearedTexture(int32_t channelIdx, vec4 &
 	Texture::SharedPtr channel = getTexture(channelIdx);
 	if (!channel) return nullptr;
 
-	mpAppCallbacks->getRenderContext()->clearUAV(channel->getUAV().get(), clearColor);
+	clearChannel(channelIdx, clearColor);
 	return channel;
 }
 
+void ResourceManager::clearChannels(const std::vector<ChannelId> &channelIds, const vec4 &clearColor)
+{
+	for (auto &id : channelIds)
+	{
+		int32_t channelIdx = getTextureIndex(id);
+		if (getTexture(channelIdx)) clearChannel(channelIdx, clearColor);
+	}
+}
+
+void ResourceManager::clearChannels(const std::vector<int32_t> &channelIdxs, const vec4 &clearColor)
+{
+	for (auto channelIdx : channelIdxs)
+	{
+		if (getTexture(channelIdx)) clearChannel(channelIdx, clearColor);
+	}
+}
+
+void ResourceManager::clearChannel(int32_t channelIdx, const vec4 &clearColor)
+{
+	RenderContext *pCtx = mpAppCallbacks->getRenderContext().get();
+	Texture::SharedPtr channel = mTextures[channelIdx];
+
+	// Is this clear needed (i.e., does the pass asking for it not overwrite the whole channel anyway)?  If so, do it.
+	bool fullyOverwritten = mExecutingPass >= 0 && mExecutingPass < int32_t(mPassFullCoverage.size()) &&
+		std::find(mPassFullCoverage[mExecutingPass].begin(), mPassFullCoverage[mExecutingPass].end(), channelIdx) != mPassFullCoverage[mExecutingPass].end();
+	bool canSkip = mClearElisionEnabled && fullyOverwritten && !mTextureCoverageFailed[channelIdx];
+	if (!canSkip)
+	{
+		pCtx->clearUAV(channel->getUAV().get(), clearColor);
+		mClearsIssued++;
+		return;
+	}
+
+	mClearsElided++;
+	if (!mVerifyElidedClears) return;
+
+	// We're verifying that the channel's writer really overwrites everything, so fill it with an unlikely value.  Read
+	//    back one texel, so we know what that value looks like in this channel's format.
+	const vec4 kSentinel = vec4(0.7071f, 0.1234f, 0.9876f, 0.4321f);
+	pCtx->clearUAV(channel->getUAV().get(), kSentinel);
+	std::vector<uint8_t> texels = pCtx->readTextureSubresource(channel.get(), 0);
+	uint32_t texelBytes = getFormatBytesPerBlock(channel->getFormat());
+	if (texels.size() < texelBytes) return;
+	mPendingCoverageChecks.push_back({ channelIdx, std::vector<uint8_t>(texels.begin(), texels.begin() + texelBytes) });
+}
+
+void ResourceManager::verifyClearCoverage()
+{
+	RenderContext *pCtx = mpAppCallbacks->getRenderContext().get();
+	for (auto &check : mPendingCoverageChecks)
+	{
+		int32_t channelIdx = check.first;
+		const std::vector<uint8_t> &sentinel = check.second;
+		if (!mTextures[channelIdx]) continue;
+
+		// Count texels that still hold the sentinel value
+		std::vector<uint8_t> texels = pCtx->readTextureSubresource(mTextures[channelIdx].get(), 0);
+		uint64_t texelCount = texels.size() / sentinel.size(), unwritten = 0;
+		for (uint64_t i = 0; i < texelCount; i++)
+		{
+			if (memcmp(&texels[i * sentinel.size()], sentinel.data(), sentinel.size()) == 0) unwritten++;
+		}
+
+		if (unwritten > 0)
+		{
+			logWarning(std::string("ResourceManager: Channel '") + mTextureNames[channelIdx] + "' is declared as fully overwritten by its pass, but " +
+				std::to_string(unwritten) + " of " + std::to_string(texelCount) + " texels were not written.  Clearing it from now on.");
+			mTextureCoverageFailed[channelIdx] = true;
+		}
+	}
+	mPendingCoverageChecks.clear();
+}
+
+void ResourceManager::updateClearElision(const RenderGraph& graph)
+{
+	mPassFullCoverage.assign(graph.getPassCount(), std::vector<int32_t>());
+	for (uint32_t pass = 0; pass < graph.getPassCount(); pass++)
+	{
+		for (auto &channel : graph.getPassFullCoverageWrites(pass))
+		{
+			int32_t channelIdx = getTextureIndex(channel);
+			if (channelIdx >= 0) mPassFullCoverage[pass].push_back(channelIdx);
+		}
+	}
+}
+
+void ResourceManager::endPassExecution()
+{
+	if (!mPendingCoverageChecks.empty()) verifyClearCoverage();
+	mExecutingPass = -1;
+}
+
 void ResourceManager::clearTexture(Texture::SharedPtr &tex, const vec4 &clearColor)
 {
 	// Figure out what type of texture this is
@@ -231,16 +711,13 @@ int32_t ResourceManager::requestTextureResource(const std::string &channelName,
 		mTextureFlags[existingIndex] |= usageFlags;
 
 		// Looks like a match!  Return an index for the exisitng resource
+		noteChannelRequest(existingIndex);
 		return existingIndex;
 	}
 
 	// No existing resource with that name.  Create one.
-	existingIndex = int32_t(mTextures.size());
-	mTextures.push_back(nullptr);    // We'll actually create the resource in initializeResources()
-	mTextureSizes.push_back(ivec2(channelWidth, channelHeight));
-	mTextureNames.push_back(channelName);
-	mTextureFlags.push_back(usageFlags);
-	mTextureFormat.push_back(channelFormat);
+	existingIndex = addChannel(channelName, channelFormat, usageFlags, ivec2(channelWidth, channelHeight), false);
+	noteChannelRequest(existingIndex);
 
 	// While we haven't changed existing resources, it's probably good to notify users that resources available have changed
 	mUpdatedFlag = true;
@@ -275,7 +752,7 @@ Fbo::SharedPtr ResourceManager::createManagedFbo(const std::vector<int32_t> &col
 	if (depthStencilBufIdx >= 0 && depthStencilBufIdx < int32_t(mTextures.size()))
 	{
 		// Was that texture set up with a DepthStencil format and binding flag?
-		if (isDepthStencilFormat(mTextureFormat[depthStencilBufIdx]) && 
+		if (isDepthStencilFormat(mTextureFormat[depthStencilBufIdx]) && mTextures[depthStencilBufIdx] &&
 			hasBindFlag(depthStencilBufIdx, Resource::BindFlags::DepthStencil))
 		{
 			pFbo->attachDepthStencilTarget(mTextures[depthStencilBufIdx]);
@@ -291,6 +768,7 @@ Fbo::SharedPtr ResourceManager::createManagedFbo(const std::vector<int32_t> &col
 		if (isDepthStencilFormat(mTextureFormat[colorBufIndicies[i]])) continue;                    // it's a depth/stencil buffer
 		if (!hasBindFlag(colorBufIndicies[i], Resource::BindFlags::RenderTarget)) continue;         // it can't be bound as a render target
 		if (i >= int32_t(Fbo::getMaxColorTargetCount())) continue;                                  // We've exceeded the number of allowable color targets
+		if (!mTextures[colorBufIndicies[i]]) continue;                                              // it's released (no active pass requested it)
 
 		pFbo->attachColorTarget(mTextures[colorBufIndicies[i]], i);
 		hasColorBuf = true;
@@ -340,12 +818,39 @@ void ResourceManager::updateTextureSize(int32_t channelIdx, int32_t newWidth, in
 	// If we haven't changed sizes, there's no reason to deallocate and reallocate the texture
 	if (mTextureSizes[channelIdx] == newSize) return;
 
-	// Update the channel
-	mTextures[channelIdx] = Texture::create2D(newSize.x, newSize.y, mTextureFormat[channelIdx], 1u, Texture::kMaxPossible, nullptr, mTextureFlags[channelIdx]);
+	std::vector<Texture::SharedPtr> previous = getPoolOwnedTextures();
+
+	// Our size no longer matches any channels we share memory with.  Give them their own textures.
+	unaliasTexture(channelIdx);
+
+	// Update the channel.  Its old texture goes back to the pool.
+	mTextures[channelIdx] = nullptr;
 	mTextureSizes[channelIdx] = newSize;
+	if (mIsInitialized) allocateTextures(false);
+	recycleTextures(previous);
 	mUpdatedFlag = true;
 }
 
+void ResourceManager::unaliasTexture(int32_t index)
+{
+	// Stop borrowing another channel's texture
+	if (mTextureAlias[index] != index)
+	{
+		mTextureAlias[index] = index;
+		mTextures[index] = nullptr;
+	}
+
+	// Stop other channels from borrowing ours
+	for (int32_t i = 0; i < int32_t(mTextures.size()); i++)
+	{
+		if (i != index && mTextureAlias[i] == index)
+		{
+			mTextureAlias[i] = i;
+			mTextures[i] = nullptr;
+		}
+	}
+}
+
 Fbo::SharedPtr ResourceManager::createFbo(uint32_t width, uint32_t height, ResourceFormat colorFormat, bool hasDepthStencil)
 {
 	Fbo::Desc desc;
@@ -18,8 +18,13 @@
 
 #pragma once
 #include "Falcor.h"
+#include "RenderGraph.h"
+#include "ChannelId.h"
+#include "ResourcePool.h"
+#include "PingPongResource.h"
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 using namespace Falcor;
 
@@ -31,6 +36,8 @@ public:
 	
 	static const std::string kOutputChannel; 
 	static const std::string kEnvironmentMap;
+	static const ChannelId   kOutputChannelId;       ///< Hashed versions of the above, for fast lookups
+	static const ChannelId   kEnvironmentMapId;
 
 	// Public ctors and dtors
 	static SharedPtr create(uint32_t width, uint32_t height, SampleCallbacks *callbacks);
@@ -59,26 +66,54 @@ public:
 	void updateTextureSize(const std::string &channelName, int32_t newWidth = -1, int32_t newHeight = -1);
 	void updateTextureSize(int32_t channelIdx, int32_t newWidth = -1, int32_t newHeight = -1);
 
-	// Get a pointer to the texture with the specified channel name or channel index.  Returns a nullptr if channel does not exist
+	// Get a pointer to the texture with the specified channel name, id, or index.  Returns a nullptr if channel does not exist.
+	//    Channel indices are stable for the life of the resource manager; ids and indices avoid string construction and compares.
 	Texture::SharedPtr getTexture(const std::string &channelName);
+	Texture::SharedPtr getTexture(const ChannelId &channelId) { return getTexture(getTextureIndex(channelId)); }
 	Texture::SharedPtr getTexture(int32_t channelIdx);
 
-	// Get a pointer to requested texture, but before returning, clear the channel
+	// Get a pointer to requested texture, but before returning, clear the channel.  (The clear is skipped if the executing
+	//    pass overwrites every texel anyway; see updateClearElision().)
 	Texture::SharedPtr getClearedTexture(const std::string &channelName, vec4 &clearColor);
+	Texture::SharedPtr getClearedTexture(const ChannelId &channelId, vec4 &clearColor) { return getClearedTexture(getTextureIndex(channelId), clearColor); }
 	Texture::SharedPtr getClearedTexture(int32_t channelIdx, vec4 &clearColor);
 
 	// If you have a texture, you can clear it here
 	void clearTexture(Texture::SharedPtr &tex, const vec4 &clearColor);
 
+	// Clear several channels back-to-back (e.g., all of a G-buffer), rather than interleaving clears with other work.
+	//    Like getClearedTexture(), clears of channels the executing pass fully overwrites are skipped.
+	void clearChannels(const std::vector<ChannelId> &channelIds, const vec4 &clearColor);
+	void clearChannels(const std::vector<int32_t> &channelIdxs, const vec4 &clearColor);
+
 	// Returns the name of the texture with the specified index
 	std::string getTextureName(int32_t channelIdx);
 
-	// Returns the channel index of the channel with the specified name (returns -1 if channel name does not exist)
+	// Returns the channel index of the channel with the specified name or id (returns -1 if channel does not exist)
 	int32_t getTextureIndex(const std::string &channelName) const;
+	int32_t getTextureIndex(const ChannelId &channelId) const;
 
 	// Return the maximum number of channels we might have (some may be invalid)
 	uint32_t getTextureCount(void) const { return uint32_t(mTextures.size()); }
 
+	// Temporal passes often need last frame's result while producing this frame's.  A history resource is a pair of 
+	//    screen-sized textures that swap roles at the end of each frame in which the write texture was requested, so 
+	//    passes read the last frame and write this frame without copying.  Histories are private to their pass, not 
+	//    channels in the render graph.  Returns an index (or the existing index, if the history already exists).
+	int32_t requestHistoryResource(const std::string &historyName, ResourceFormat format = ResourceFormat::RGBA32Float, Resource::BindFlags usageFlags = kDefaultFlags);
+	int32_t getHistoryIndex(const std::string &historyName) const;
+
+	// Get the texture holding last frame's result, or the texture to write this frame's result into.  (The latter
+	//    marks the history as written, so it swaps at the end of the frame.)  Returns nullptr for invalid indices.
+	Texture::SharedPtr getHistoryRead(int32_t historyIdx);
+	Texture::SharedPtr getHistoryWrite(int32_t historyIdx);
+
+	// Which texture of the pair getHistoryWrite() returns this frame (0 or 1), e.g., for caching an FBO per texture
+	uint32_t getHistoryWriteSlot(int32_t historyIdx) const;
+
+	// Does getHistoryRead() hold a prior frame's result?  False until one frame is written, and after resizes.
+	bool hasValidHistory(int32_t historyIdx) const;
+
 	// Will update the stored environment map to the specified file.  Returns <true> if
 	//     the resource manager was able to load the specified file.  If the load fails,
 	//     the prior environment map is still used.
@@ -86,7 +121,7 @@ public:
 
 	// Get details about the internally managed environment map
 	std::string  getEnvironmentMapName(void) const { return mEnvMapFilename; }
-	Texture::SharedPtr getEnvironmentMap() { return getTexture( kEnvironmentMap );  }
+	Texture::SharedPtr getEnvironmentMap() { return getTexture( kEnvironmentMapId );  }
 	uvec2 getEnvironmentMapSize() const;
 
 	// Creates a framebuffer from a set of resources managed by the ResourceManager.  
@@ -129,6 +164,72 @@ public:
     uint32_t getHeight() const     { return mHeight; }
 	uvec2    getScreenSize() const { return uvec2(mWidth, mHeight); }
 
+	// Lets channels whose lifetimes (in the graph's execution order) don't overlap share texture memory.  Channels
+	//    with matching format, bind flags, and size can alias.  Returns true if any texture pointers changed.  Opaque
+	//    passes are assumed to read and write every channel they requested; <graphPassOwners> gives the channel owner
+	//    (see beginChannelRequests()) of each graph pass, so we know what those are.  If an opaque pass has no known 
+	//    owner (or aliasing is disabled), all aliasing is removed.
+	bool updateTextureAliasing(const RenderGraph& graph, const std::vector<const void*>& graphPassOwners = {});
+
+	// Enable or disable transient texture aliasing.  Takes effect on the next updateTextureAliasing() call.
+	void setTextureAliasingEnabled(bool enable) { mAliasingEnabled = enable; }
+	bool isTextureAliasingEnabled() const       { return mAliasingEnabled; }
+
+	// Memory statistics for managed textures (at the current screen size):  bytes if every channel had its own 
+	//    texture, and bytes actually allocated given the current aliasing
+	uint64_t getUnaliasedTextureBytes() const;
+	uint64_t getAllocatedTextureBytes() const;
+
+	// A pass' clears of channels it fully overwrites are redundant (see RenderPass::declareChannelWrite()), so we 
+	//    skip them.  Call updateClearElision() when the pipeline's graph changes, and bracket each pass' execution
+	//    with beginPassExecution() and endPassExecution(), so we know whose clears we're seeing.  Clears outside
+	//    a pass (or by passes that don't declare their channels) are never skipped.
+	void updateClearElision(const RenderGraph& graph);
+	void beginPassExecution(uint32_t graphPassIdx) { mExecutingPass = int32_t(graphPassIdx); }
+	void endPassExecution();
+	void setClearElisionEnabled(bool enable)  { mClearElisionEnabled = enable; }
+	bool isClearElisionEnabled() const        { return mClearElisionEnabled; }
+
+	// Debug mode:  instead of skipping clears, fill channels with a sentinel value, then (after the pass runs) read 
+	//    them back and check that every texel was overwritten.  Channels failing the check are cleared from then on.  
+	//    This stalls the GPU; only use it to test a pass' coverage claims.
+	void setClearVerificationEnabled(bool enable) { mVerifyElidedClears = enable; }
+	bool isClearVerificationEnabled() const       { return mVerifyElidedClears; }
+
+	// Number of clears issued and skipped last frame
+	uint32_t getClearsIssued() const  { return mLastFrameClearsIssued; }
+	uint32_t getClearsElided() const  { return mLastFrameClearsElided; }
+
+	// Managed textures are recycled through a pool (keyed by format, size, and bind flags), so resizes and pipeline changes 
+	//    reuse existing allocations where possible.  Passes can use the same pool for their own internal textures; 
+	//    releasing a texture nulls the caller's pointer, and the memory may be handed to another acquirer next frame.
+	Texture::SharedPtr acquirePooledTexture(uint32_t width, uint32_t height, ResourceFormat format = ResourceFormat::RGBA32Float, Resource::BindFlags usageFlags = kDefaultFlags);
+	void releasePooledTexture(Texture::SharedPtr &tex);
+
+	// Channels a pass requests are only backed by textures while that pass is active in the pipeline.  Bracket a pass'
+	//    requests (i.e., its initialize()) with beginChannelRequests() / endChannelRequests() so we know who asked for
+	//    what, then activate and deactivate it as it enters and leaves the pipeline (RenderPass does all this).  When a
+	//    channel has no active requester, its texture goes back to the pool; reactivating picks it back up from there,
+	//    if it hasn't been evicted yet.  Requests made outside these brackets (e.g., by the pipeline) are kept forever.
+	void beginChannelRequests(const void *pOwner) { mpRequestingOwner = pOwner; }
+	void endChannelRequests()                     { mpRequestingOwner = nullptr; }
+	void activateChannelOwner(const void *pOwner);
+	void deactivateChannelOwner(const void *pOwner);
+
+	// Releases are deferred until this is called (e.g., once the pipeline has settled after a change).  Returns true if
+	//    any channel's texture changed.
+	bool updateChannelResidency();
+
+	// How many active requesters does this channel have (counting requests made outside any owner as one)?  Channels
+	//    with none have no texture.
+	uint32_t getChannelRefCount(int32_t channelIdx) const;
+	bool isChannelResident(int32_t channelIdx) const { return getChannelRefCount(channelIdx) > 0; }
+	uint32_t getReleasedChannelCount() const;
+
+	// Call once per frame, after all passes execute.  Swaps written history resources and frees pooled textures 
+	//    that have gone unused for a while.
+	void endFrame();
+
 	// If resources have changed since last frame (and previous resource pointers may be invalid), this will return true
 	bool haveResourcesChanged() const { return mUpdatedFlag; }
 
@@ -140,7 +241,20 @@ public:
 	void  setMinTDist(float newMinT) { mMinT = newMinT; }
 
 protected:
-	ResourceManager(uint32_t width, uint32_t height, SampleCallbacks *callbacks) : mWidth(width), mHeight(height), mpAppCallbacks(callbacks) {}
+	ResourceManager(uint32_t width, uint32_t height, SampleCallbacks *callbacks);
+
+	// Describes a texture for the purposes of recycling it.  Only textures with identical keys are interchangeable.
+	struct TexturePoolKey
+	{
+		ResourceFormat      format;
+		Resource::BindFlags bindFlags;
+		uint32_t            width;
+		uint32_t            height;
+		bool operator==(const TexturePoolKey& other) const 
+		{ 
+			return format == other.format && bindFlags == other.bindFlags && width == other.width && height == other.height; 
+		}
+	};
 
     // Various internal state
     uint32_t mWidth = 0;    
@@ -165,9 +279,73 @@ protected:
 	std::vector<glm::ivec2>           mTextureSizes;     ///< Stored separately from internal texture data so we can distinguish between fixed & fullscreen textures
 	std::vector<Resource::BindFlags>  mTextureFlags;     ///< Expected usage flags
 	std::vector<ResourceFormat>       mTextureFormat;    ///< Expected texture format
+	std::vector<int32_t>              mTextureAlias;     ///< Index of the channel whose texture memory this channel shares (itself, if not aliased)
+	std::vector<bool>                 mTextureExternal;  ///< Was this texture passed in via manageTextureResource()?  (If so, never alias it.)
+	std::unordered_map<uint64_t, int32_t> mChannelLookup; ///< Maps ChannelId hashes to indices into the arrays above
+	bool                              mAliasingEnabled = true;
+	ResourcePool<TexturePoolKey, Texture::SharedPtr> mTexturePool;  ///< Textures no longer bound to a channel (or pass), kept for reuse
+
+	// Which requesters want each channel, and which requesters are active
+	std::vector<std::vector<const void*>> mChannelOwners;      ///< Per channel, the requesters that asked for it
+	std::vector<bool>                 mChannelPinned;          ///< Per channel, was it requested outside any requester (so is always resident)?
+	std::map<const void*, uint32_t>   mOwnerActivations;       ///< Requesters currently active (and how many times, e.g., if in the pipeline twice)
+	const void*                       mpRequestingOwner = nullptr;
+	bool                              mResidencyDirty = false;  ///< Has a requester been deactivated since the last updateChannelResidency()?
+
+	// Clear elision state
+	std::vector<std::vector<int32_t>> mPassFullCoverage;         ///< Per RenderGraph pass, the channels it overwrites entirely
+	std::vector<bool>                 mTextureCoverageFailed;    ///< Did clear verification show this channel isn't entirely overwritten?
+	int32_t                           mExecutingPass = -1;       ///< RenderGraph index of the pass currently executing
+	bool                              mClearElisionEnabled = true;
+	bool                              mVerifyElidedClears = false;
+	uint32_t                          mClearsIssued = 0, mClearsElided = 0;
+	uint32_t                          mLastFrameClearsIssued = 0, mLastFrameClearsElided = 0;
+
+	// Channels filled with the sentinel value by the executing pass (during clear verification), and the bytes of one sentinel texel
+	std::vector<std::pair<int32_t, std::vector<uint8_t>>> mPendingCoverageChecks;
+
+	// Double-buffered history resources (always screen-sized)
+	std::vector<PingPongResource<Texture::SharedPtr>> mHistories;
+	std::vector<std::string>          mHistoryNames;
+	std::vector<ResourceFormat>       mHistoryFormat;
+	std::vector<Resource::BindFlags>  mHistoryFlags;
 
 private:
 	// These are not meant to be exposed outside the class and may not have suitable error checking non-private use.
 	bool hasBindFlag(int32_t index, Resource::BindFlags flag);
 
+	// Creates textures for channels that own their memory, then points aliased channels at their owner's texture.
+	//    If <recreateScreenSized> is true, existing screen-sized textures are reallocated (e.g., on resize).
+	void allocateTextures(bool recreateScreenSized);
+
+	// (Re)allocates both textures of the specified history at the current screen size, discarding its contents
+	void allocateHistory(int32_t historyIdx);
+
+	// Clears the specified channel, unless its clear can be skipped (or should be replaced by a sentinel fill)
+	void clearChannel(int32_t channelIdx, const vec4 &clearColor);
+
+	// Checks channels filled with sentinels (see setClearVerificationEnabled()) were overwritten by the executing pass
+	void verifyClearCoverage();
+
+	// Returns the textures that belong to the pool (i.e., weren't passed in via manageTextureResource()), one entry per channel
+	std::vector<Texture::SharedPtr> getPoolOwnedTextures() const;
+
+	// Records that the current requester (see beginChannelRequests()) wants the specified channel
+	void noteChannelRequest(int32_t index);
+
+	// Per channel, does its texture need to exist?  True for channels owning memory that any resident channel uses.
+	std::vector<bool> getNeededTextures() const;
+
+	// Returns textures from <previous> that are no longer used by any channel to the pool
+	void recycleTextures(const std::vector<Texture::SharedPtr> &previous);
+
+	// Gives the specified channel (and any channels sharing its memory) their own textures.  Caller must reallocate.
+	void unaliasTexture(int32_t index);
+
+	// Adds the arrays' entries for a new channel.  Returns the new channel's index.
+	int32_t addChannel(const std::string &channelName, ResourceFormat channelFormat, Resource::BindFlags usageFlags, ivec2 channelSize, bool isExternal);
+
+	// Size in bytes of the specified channel's texture at the current screen size
+	uint64_t getTextureBytes(int32_t index) const;
+
 };
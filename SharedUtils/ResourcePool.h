@@ -0,0 +1,129 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/** A pool of recyclable resources (e.g., textures), keyed by a description of the resource.
+
+Released resources are not destroyed right away; they sit in the pool's free list and are handed back out by 
+acquire() calls with a matching key.  This means a burst of resizes (or passes toggling back and forth) reuses 
+the same allocations rather than hitting the driver every time.  Resources that go unused for framesToKeep 
+frames (or that exceed the pool's capacity, oldest first) are finally dropped in endFrame().
+
+Key must be equality comparable.  Resource is expected to be a (smart) pointer type, where a default-constructed 
+value means "no resource."  Allocation goes through a user-provided function, so the pool policy does not 
+depend on a graphics device and can be driven by a mock allocator.
+
+Usage:
+     ResourcePool<Key, Texture::SharedPtr> pool([](const Key& k) { return Texture::create2D(...); });
+     Texture::SharedPtr tex = pool.acquire(key);   // Reuses a released texture with this key, if one exists
+     pool.release(key, tex);                       // Back in the pool; still alive until evicted
+     pool.endFrame();                              // Once per frame; evicts stale resources
+*/
+template <typename Key, typename Resource>
+class ResourcePool
+{
+public:
+	using Allocator = std::function<Resource(const Key&)>;
+
+	// Running counts, so callers can report how much allocation work the pool saved
+	struct Stats
+	{
+		uint64_t allocations = 0;   ///< acquire() calls that needed a new resource
+		uint64_t reuses = 0;        ///< acquire() calls satisfied from the free list
+		uint64_t releases = 0;      ///< Resources returned to the pool
+		uint64_t evictions = 0;     ///< Released resources that were eventually dropped
+	};
+
+	ResourcePool(Allocator allocator, uint32_t framesToKeep = 120, uint32_t maxPooled = 32) 
+		: mAllocator(allocator), mFramesToKeep(framesToKeep), mMaxPooled(maxPooled) {}
+
+	// Get a resource matching <key>.  The most recently released match is reused (it's the most likely to 
+	//    still be resident); if there is none, a new resource is allocated.  
+	Resource acquire(const Key& key)
+	{
+		for (size_t i = mFree.size(); i-- > 0; )
+		{
+			if (!(mFree[i].key == key)) continue;
+
+			Resource res = mFree[i].resource;
+			mFree.erase(mFree.begin() + i);
+			mStats.reuses++;
+			return res;
+		}
+
+		mStats.allocations++;
+		return mAllocator(key);
+	}
+
+	// Return a resource to the pool.  The caller must no longer use it (and should drop its reference).
+	void release(const Key& key, const Resource& res)
+	{
+		if (!res) return;
+		mFree.push_back({ key, res, mFrame });
+		mStats.releases++;
+
+		// Over capacity?  Drop the oldest entries (i.e., those at the front of the list)
+		if (mFree.size() > mMaxPooled)
+			evict(mFree.size() - mMaxPooled);
+	}
+
+	// Advance the pool's clock and drop resources that have gone unused for too long
+	void endFrame()
+	{
+		mFrame++;
+		size_t staleCount = 0;
+		while (staleCount < mFree.size() && mFrame - mFree[staleCount].releaseFrame > mFramesToKeep)
+			staleCount++;
+		evict(staleCount);
+	}
+
+	// Drop every resource currently in the pool
+	void clear()                         { evict(mFree.size()); }
+
+	uint32_t getPooledCount() const      { return uint32_t(mFree.size()); }
+	const Stats& getStats() const        { return mStats; }
+	void resetStats()                    { mStats = Stats(); }
+
+protected:
+	struct Entry
+	{
+		Key      key;
+		Resource resource;
+		uint64_t releaseFrame;
+	};
+
+	// Removes the <count> oldest entries.  The free list is ordered by release time.
+	void evict(size_t count)
+	{
+		if (count == 0) return;
+		mFree.erase(mFree.begin(), mFree.begin() + count);
+		mStats.evictions += count;
+	}
+
+	Allocator          mAllocator;
+	std::vector<Entry> mFree;              ///< Released resources, oldest first
+	uint64_t           mFrame = 0;
+	uint32_t           mFramesToKeep;
+	uint32_t           mMaxPooled;
+	Stats              mStats;
+};
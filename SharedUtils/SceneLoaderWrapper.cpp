@@ -17,6 +17,12 @@
 **********************************************************************************************************************/
 
 #include "SceneLoaderWrapper.h"
+#include "JobSystem.h"
+#include "SceneRegistry.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
 
 using namespace Falcor;
 
@@ -24,9 +30,38 @@ namespace {
     // Required for later versions of Falcor (post 3.1.0)
     //const FileDialogFilterVec kSceneExtensions = { {"fscene"} };
     //const FileDialogFilterVec kTextureExtensions = { { "hdr" }, { "png" }, { "jpg" }, { ".bmp" } };
+
+	// The files an .fscene pulls in (the values of its "file" keys, resolved against the scene's directory), plus the .fscene itself
+	std::vector<std::string> findSceneSources(const std::string &scenePath)
+	{
+		std::vector<std::string> sources = { scenePath };
+		std::ifstream file(scenePath);
+		if (!file.good()) return sources;
+		std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		// Find each "file" : "<path>".  This isn't a JSON parser, but .fscene files only use the key for file references.
+		size_t slash = scenePath.find_last_of("/\\");
+		std::string dir = (slash == std::string::npos) ? std::string() : scenePath.substr(0, slash + 1);
+		const std::string key = "\"file\"";
+		for (size_t pos = text.find(key); pos != std::string::npos; pos = text.find(key, pos + key.size()))
+		{
+			size_t colon = text.find_first_not_of(" \t\r\n", pos + key.size());
+			if (colon == std::string::npos || text[colon] != ':') continue;
+			size_t open = text.find_first_not_of(" \t\r\n", colon + 1);
+			if (open == std::string::npos || text[open] != '"') continue;
+			size_t close = text.find('"', open + 1);
+			if (close == std::string::npos) break;
+
+			std::string path = text.substr(open + 1, close - open - 1);
+			bool isAbsolute = !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+			std::string resolved = isAbsolute ? path : dir + path;
+			if (std::find(sources.begin(), sources.end(), resolved) == sources.end()) sources.push_back(resolved);
+		}
+		return sources;
+	}
 };
 
-Falcor::RtScene::SharedPtr loadScene( uvec2 currentScreenSize, const char *defaultFilename )
+Falcor::RtScene::SharedPtr loadScene( uvec2 currentScreenSize, const char *defaultFilename, bool removeInstancing )
 {
 	RtScene::SharedPtr pScene;
 
@@ -55,7 +90,39 @@ Falcor::RtScene::SharedPtr loadScene( uvec2 currentScreenSize, const char *defau
 	// Load a scene
 	if (hasSuffix(filename, ".fscene", false))
 	{
-		pScene = RtScene::loadFromFile(filename, RtBuildFlags::None, Model::LoadFlags::RemoveInstancing);
+		auto loadStart = std::chrono::high_resolution_clock::now();
+
+		// Falcor's loader reads and decodes the scene's models one after another.  Read them ahead on the job pool,
+		//     so its reads mostly hit the OS file cache and disk I/O overlaps its decoding.  That only hides read time:
+		//     Falcor 3.1 has no hook to hand decoding to other threads, so it stays serial.
+		std::vector<JobSystem::Job::SharedPtr> prefetches = JobSystem::getShared()->prefetchFiles(findSceneSources(filename));
+
+		// Keep instanced meshes instanced:  one bottom-level acceleration structure per mesh, with each instance's transform
+		//     in the top level.  Each instance still gets its own hit records (with the mesh's vertex data and material).
+		Model::LoadFlags modelFlags = removeInstancing ? Model::LoadFlags::RemoveInstancing : Model::LoadFlags::None;
+		uint32_t accelFlags = SceneRegistry::getShared()->getAccelBuildFlags(filename);
+		pScene = RtScene::loadFromFile(filename, RtBuildFlags(accelFlags), modelFlags);
+
+		// Prefetches still queued are too late to help.  (Reads already under way just finish.)
+		for (auto &pPrefetch : prefetches)
+			pPrefetch->cancel();
+		float loadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+		SceneRegistry::getShared()->recordSceneLoad(loadMs);
+		logInfo("loadScene(): Loaded '" + filename + "' in " + std::to_string(loadMs) + " ms");
+
+		SceneRegistry::SharedPtr pRegistry = SceneRegistry::getShared();
+		pRegistry->recordSceneGeometry(pScene);
+		const SceneRegistry::Stats &stats = pRegistry->getStats();
+		logInfo("loadScene(): " + std::to_string(stats.uniqueMeshes) + " meshes, " + std::to_string(stats.meshInstances) + " instances; geometry uses " +
+			std::to_string(stats.geometryBytes >> 20) + " MB (" + std::to_string(stats.flattenedBytes >> 20) + " MB with instances flattened)");
+
+		// Check the build flags suited the scene (we can't know what animates until it's loaded).  If not, the next load gets it right.
+		if (!pRegistry->recordAccelBuild(filename, pScene, accelFlags))
+		{
+			logWarning("loadScene(): '" + filename + "' was built with " + AccelBuildPolicy::toString(accelFlags) + ", but its animation calls for " +
+				AccelBuildPolicy::toString(pRegistry->getAccelBuildFlags(filename)) + ", which it will get when next loaded");
+		}
+		logInfo("loadScene(): " + std::to_string(stats.blasCount) + " bottom-level acceleration structures, " + std::to_string(stats.blasBytes >> 10) + " KB");
 
 		// If we have a valid scene, do some sanity checking; set some defaults
 		if (pScene)
@@ -36,7 +36,8 @@
 
 // Load a scene, with an aspect ratio determined by the specified size.  If a filename is specified,
 //    load that scene.  If no filename specified, a dialog box is opened so the user can select a file to load.
-Falcor::RtScene::SharedPtr loadScene( uvec2 currentScreenSize, const char *defaultFilename = 0 );
+//    Instanced meshes stay instanced unless removeInstancing is set, which gives each instance its own copy.
+Falcor::RtScene::SharedPtr loadScene( uvec2 currentScreenSize, const char *defaultFilename = 0, bool removeInstancing = false );
 
 
 // Opens a file dialog looking for textures.  Returns the full path name.
@@ -0,0 +1,212 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "SceneRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace {
+	// How we key a scene file's learned build flags in the cache:  by its path, its contents, and the build mode
+	ShaderCache::ProgramDesc describeAccelFlagEntry(const std::string &filename, AccelBuildPolicy::Mode mode)
+	{
+		ShaderCache::ProgramDesc desc;
+		desc.sourceFiles = { filename };
+		desc.defines = { { "SCENE_FILE", filename }, { "ACCEL_BUILD_MODE", AccelBuildPolicy::toString(mode) } };
+		desc.target = "accel-build-flags";
+		return desc;
+	}
+};
+
+SceneRegistry::SharedPtr SceneRegistry::getShared()
+{
+	static SharedPtr spShared = []()
+	{
+		SharedPtr pRegistry = create();
+		pRegistry->setAccelFlagCache(ShaderCache::create("ShaderCache", getDataDirectoriesList()));
+		return pRegistry;
+	}();
+	return spShared;
+}
+
+void SceneRegistry::pruneExpired()
+{
+	mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+		[](const Entry &entry) { return entry.pScene.expired() || entry.pRenderer.expired(); }), mEntries.end());
+}
+
+RtSceneRenderer::SharedPtr SceneRegistry::acquireRenderer(const RtScene::SharedPtr &pScene)
+{
+	if (!pScene) return nullptr;
+	pruneExpired();
+
+	for (auto &entry : mEntries)
+	{
+		if (entry.pScene.lock() == pScene)
+		{
+			RtSceneRenderer::SharedPtr pRenderer = entry.pRenderer.lock();
+			if (pRenderer)
+			{
+				mStats.renderersShared++;
+				return pRenderer;
+			}
+		}
+	}
+
+	RtSceneRenderer::SharedPtr pRenderer = RtSceneRenderer::create(pScene);
+	if (!pRenderer) return nullptr;
+	mEntries.push_back({ pScene, pRenderer });
+	mStats.renderersCreated++;
+	return pRenderer;
+}
+
+uint32_t SceneRegistry::getLiveRendererCount()
+{
+	pruneExpired();
+	return uint32_t(mEntries.size());
+}
+
+uint32_t SceneRegistry::getRendererUserCount()
+{
+	pruneExpired();
+	uint32_t users = 0;
+	for (auto &entry : mEntries)
+		users += uint32_t(entry.pRenderer.use_count());
+	return users;
+}
+
+void SceneRegistry::recordSceneGeometry(const RtScene::SharedPtr &pScene)
+{
+	mStats.uniqueMeshes = mStats.meshInstances = 0;
+	mStats.geometryBytes = mStats.flattenedBytes = 0;
+	if (!pScene) return;
+
+	// Count each buffer once, however many meshes or instances use it
+	std::set<const Buffer*> counted;
+	for (uint32_t modelId = 0; modelId < pScene->getModelCount(); modelId++)
+	{
+		const Model::SharedPtr &pModel = pScene->getModel(modelId);
+		uint32_t modelInstances = pScene->getModelInstanceCount(modelId);
+		for (uint32_t meshId = 0; meshId < pModel->getMeshCount(); meshId++)
+		{
+			const Vao::SharedPtr &pVao = pModel->getMesh(meshId)->getVao();
+			std::vector<const Buffer*> buffers = { pVao->getIndexBuffer().get() };
+			for (uint32_t i = 0; i < pVao->getVertexBuffersCount(); i++)
+				buffers.push_back(pVao->getVertexBuffer(i).get());
+
+			uint64_t meshBytes = 0;
+			for (const Buffer *pBuffer : buffers)
+			{
+				if (!pBuffer) continue;
+				meshBytes += pBuffer->getSize();
+				if (counted.insert(pBuffer).second) mStats.geometryBytes += pBuffer->getSize();
+			}
+
+			uint32_t instances = modelInstances * pModel->getMeshInstanceCount(meshId);
+			mStats.uniqueMeshes++;
+			mStats.meshInstances += instances;
+			mStats.flattenedBytes += meshBytes * instances;
+		}
+	}
+}
+
+AccelBuildPolicy::SceneDesc SceneRegistry::describeForAccelBuild(const RtScene::SharedPtr &pScene)
+{
+	AccelBuildPolicy::SceneDesc desc;
+	if (!pScene) return desc;
+
+	for (uint32_t modelId = 0; modelId < pScene->getModelCount(); modelId++)
+	{
+		const Model::SharedPtr &pModel = pScene->getModel(modelId);
+		if (pModel->hasAnimations()) desc.hasAnimations = true;
+		for (uint32_t meshId = 0; meshId < pModel->getMeshCount(); meshId++)
+		{
+			const Mesh::SharedPtr &pMesh = pModel->getMesh(meshId);
+			AccelBuildPolicy::MeshDesc mesh;
+			mesh.deforming = pMesh->hasBones();
+			mesh.triangleCount = pMesh->getPrimitiveCount();
+			desc.meshes.push_back(mesh);
+		}
+	}
+
+	// Paths moving the camera don't move any geometry; paths moving anything else do
+	for (uint32_t pathId = 0; pathId < pScene->getPathCount(); pathId++)
+	{
+		const ObjectPath::SharedPtr &pPath = pScene->getPath(pathId);
+		for (uint32_t i = 0; i < pPath->getAttachedObjectCount(); i++)
+		{
+			if (std::dynamic_pointer_cast<Camera>(pPath->getAttachedObject(i))) desc.hasCameraPath = true;
+			else desc.hasObjectPaths = true;
+		}
+	}
+	return desc;
+}
+
+uint32_t SceneRegistry::getAccelBuildFlags(const std::string &filename)
+{
+	auto learned = mLearnedAccelFlags.find(std::make_pair(filename, mAccelMode));
+	if (learned != mLearnedAccelFlags.end()) return learned->second;
+
+	// Not loaded yet this run?  Then maybe an earlier run loaded it
+	if (mpAccelFlagCache)
+	{
+		ShaderCache::Key key = mpAccelFlagCache->computeKey(describeAccelFlagEntry(filename, mAccelMode));
+		std::vector<uint8_t> blob;
+		uint32_t flags = 0;
+		if (key.valid && mpAccelFlagCache->load(key, blob) && blob.size() == sizeof(flags))
+		{
+			memcpy(&flags, blob.data(), sizeof(flags));
+			mLearnedAccelFlags[std::make_pair(filename, mAccelMode)] = flags;
+			return flags;
+		}
+	}
+	return AccelBuildPolicy::select(AccelBuildPolicy::SceneDesc(), mAccelMode).combinedFlags;
+}
+
+bool SceneRegistry::recordAccelBuild(const std::string &filename, const RtScene::SharedPtr &pScene, uint32_t builtFlags)
+{
+	mStats.accelFlags = builtFlags;
+	mStats.blasCount = 0;
+	mStats.blasBytes = mStats.blasCompactedBytes = 0;
+	if (!pScene) return true;
+
+	// Falcor allocates each bottom-level structure at its (uncompacted) prebuild size, and doesn't compact them
+	for (uint32_t modelId = 0; modelId < pScene->getModelCount(); modelId++)
+	{
+		RtModel::SharedPtr pRtModel = std::dynamic_pointer_cast<RtModel>(pScene->getModel(modelId));
+		if (!pRtModel) continue;
+		for (uint32_t i = 0; i < pRtModel->getBottomLevelDataCount(); i++)
+		{
+			const Buffer::SharedPtr &pBlas = pRtModel->getBottomLevelData(i).pBlas;
+			if (!pBlas) continue;
+			mStats.blasCount++;
+			mStats.blasBytes += pBlas->getSize();
+		}
+	}
+
+	AccelBuildPolicy::Selection selection = AccelBuildPolicy::select(describeForAccelBuild(pScene), mAccelMode);
+	mLearnedAccelFlags[std::make_pair(filename, mAccelMode)] = selection.combinedFlags;
+	if (mpAccelFlagCache && selection.combinedFlags != builtFlags)
+	{
+		ShaderCache::Key key = mpAccelFlagCache->computeKey(describeAccelFlagEntry(filename, mAccelMode));
+		std::vector<uint8_t> blob(sizeof(selection.combinedFlags));
+		memcpy(blob.data(), &selection.combinedFlags, blob.size());
+		if (key.valid) mpAccelFlagCache->store(key, blob);
+	}
+	return selection.combinedFlags == builtFlags;
+}
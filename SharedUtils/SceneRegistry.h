@@ -0,0 +1,123 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include "Falcor.h"
+#include "AccelBuildPolicy.h"
+#include "ShaderCache.h"
+#include <map>
+#include <vector>
+
+using namespace Falcor;
+
+/** Shares one RtSceneRenderer per RtScene between every RayLaunch (and anything else) that renders the scene.
+
+Each pass' RayLaunch used to create its own renderer in setScene(), so a pipeline of N ray tracing passes
+built N renderers for the same scene.  Now they ask the registry, which hands out the existing renderer if
+anyone still holds one.  Entries are reference counted through the returned shared pointers, so a scene's
+renderer goes away when the last launch using it does (or switches to a new scene).  The acceleration
+structures themselves are owned by the RtScene, so sharing the scene object shares those.
+
+The registry also records how long the last scene took to load and to hand to the pipeline's passes, and how
+much geometry memory instancing saved it.  Renderer sharing is reported as object counts, not bytes:  Falcor
+doesn't expose what a renderer allocates, so we can't say how much memory each avoided duplicate would have used.  And it picks each scene's acceleration structure build flags (see
+AccelBuildPolicy), remembering what a scene file turned out to need for the next time it's loaded (in this run or a later one).
+
+Usage:
+     RtSceneRenderer::SharedPtr pRenderer = SceneRegistry::getShared()->acquireRenderer(pScene);
+*/
+class SceneRegistry : public std::enable_shared_from_this<SceneRegistry>
+{
+public:
+	using SharedPtr = std::shared_ptr<SceneRegistry>;
+	using SharedConstPtr = std::shared_ptr<const SceneRegistry>;
+	virtual ~SceneRegistry() = default;
+
+	struct Stats
+	{
+		uint32_t renderersCreated = 0;   ///< Renderers built (over the registry's lifetime)
+		uint32_t renderersShared = 0;    ///< Requests answered with an existing renderer, i.e., renderer creations avoided (a count, not bytes)
+		float    lastLoadMs = 0.0f;      ///< Time to load the last scene from disk
+		float    lastPassSetupMs = 0.0f; ///< Time for passes to accept the last scene (e.g., in RenderPass::initScene())
+		uint32_t uniqueMeshes = 0;       ///< Meshes in the last scene (one bottom-level acceleration structure each)
+		uint32_t meshInstances = 0;      ///< Placements of those meshes (one top-level instance each)
+		uint64_t geometryBytes = 0;      ///< Vertex and index buffer memory the last scene actually uses
+		uint64_t flattenedBytes = 0;     ///< What it would use with every instance flattened into its own copy (RemoveInstancing)
+		uint32_t accelFlags = 0;         ///< AccelBuildPolicy::Flags the last scene's acceleration structures were built with
+		uint32_t blasCount = 0;          ///< Bottom-level structures in the last scene
+		uint64_t blasBytes = 0;          ///< Their size as built
+		uint64_t blasCompactedBytes = 0; ///< Their size after compaction (0 if they weren't compacted)
+	};
+
+	static SharedPtr create() { return SharedPtr(new SceneRegistry()); }
+
+	// The registry shared by everything in the process
+	static SharedPtr getShared();
+
+	// Get the renderer for a scene, creating it if no one else holds one.  Keep the returned pointer while you use it.
+	RtSceneRenderer::SharedPtr acquireRenderer(const RtScene::SharedPtr &pScene);
+
+	// How many scenes currently have a live renderer?  How many holders do they have, in total?
+	uint32_t getLiveRendererCount();
+	uint32_t getRendererUserCount();
+
+	// Timing for scene loads (recorded by the scene loader and rendering pipeline)
+	void recordSceneLoad(float loadMs)           { mStats.lastLoadMs = loadMs; }
+	void recordScenePassSetup(float passSetupMs) { mStats.lastPassSetupMs = passSetupMs; }
+
+	// Count the geometry in a newly loaded scene, with and without instancing
+	void recordSceneGeometry(const RtScene::SharedPtr &pScene);
+
+	// How loadScene() picks acceleration structure build flags (applies to the next scene loaded)
+	void setAccelBuildMode(AccelBuildPolicy::Mode mode) { mAccelMode = mode; }
+	AccelBuildPolicy::Mode getAccelBuildMode() const    { return mAccelMode; }
+
+	// Flags to build a scene file with.  What animates in a scene is only known once it's loaded, so until we've
+	//     seen the file (or, if it's been edited, its new version) this assumes static geometry.
+	uint32_t getAccelBuildFlags(const std::string &filename);
+
+	// Where the flags each scene file called for are kept between runs, keyed by the file's path and contents
+	//     (the shared registry uses "ShaderCache/").  Pass nullptr to only remember them in memory.
+	void setAccelFlagCache(ShaderCache::SharedPtr pCache) { mpAccelFlagCache = pCache; }
+
+	// Pick the build policy for a loaded scene, remember it for the next time the file is loaded, and record the
+	//     size of its acceleration structures.  Returns false if the scene was built with flags that don't suit it.
+	bool recordAccelBuild(const std::string &filename, const RtScene::SharedPtr &pScene, uint32_t builtFlags);
+
+	// What animates in a scene, as the build policy needs to know
+	static AccelBuildPolicy::SceneDesc describeForAccelBuild(const RtScene::SharedPtr &pScene);
+
+	const Stats &getStats() const { return mStats; }
+
+protected:
+	SceneRegistry() = default;
+
+	// Forget entries whose scene or renderer no longer exists
+	void pruneExpired();
+
+	struct Entry
+	{
+		std::weak_ptr<RtScene>          pScene;      ///< Weak, so we never keep a scene alive (and a reused address can't match a dead scene)
+		std::weak_ptr<RtSceneRenderer>  pRenderer;
+	};
+	std::vector<Entry>               mEntries;
+	Stats                            mStats;
+	AccelBuildPolicy::Mode           mAccelMode = AccelBuildPolicy::Mode::Automatic;
+	std::map<std::pair<std::string, AccelBuildPolicy::Mode>, uint32_t>  mLearnedAccelFlags;   ///< Per scene file and mode, the flags its last load called for
+	ShaderCache::SharedPtr           mpAccelFlagCache;     ///< Persists mLearnedAccelFlags (may be null)
+};
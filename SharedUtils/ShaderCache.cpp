@@ -0,0 +1,335 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "ShaderCache.h"
+#include "Fnv1a.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+	// Entry header.  Fields are written individually (little-endian, as on all our platforms) so there's no padding to worry about
+	const size_t kHeaderSize = 4 + 4 + 8 + 8 + 8;   // magic, version, key, payload size, payload hash
+	const char*  kEntryExtension = ".shc";
+
+	void appendBytes(std::vector<uint8_t> &out, const void *pData, size_t size)
+	{
+		const uint8_t *pBytes = reinterpret_cast<const uint8_t*>(pData);
+		out.insert(out.end(), pBytes, pBytes + size);
+	}
+
+	template <typename T> T readValue(const std::vector<uint8_t> &in, size_t offset)
+	{
+		T value;
+		memcpy(&value, in.data() + offset, sizeof(T));
+		return value;
+	}
+
+	uint64_t hashString(const std::string &str, uint64_t seed)
+	{
+		// Include the length, so ("ab","c") and ("a","bc") hash differently
+		uint64_t len = str.size();
+		return Fnv1a::hashBytes(str.data(), str.size(), Fnv1a::hashBytes(&len, sizeof(len), seed));
+	}
+
+	bool readFile(const std::string &path, std::string &contents)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.good()) return false;
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		contents = buffer.str();
+		return true;
+	}
+
+	std::string directoryOf(const std::string &path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return (slash == std::string::npos) ? std::string() : path.substr(0, slash + 1);
+	}
+
+	std::string fileNameOf(const std::string &path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return (slash == std::string::npos) ? path : path.substr(slash + 1);
+	}
+
+	bool fileExists(const std::string &path)
+	{
+		std::ifstream file(path);
+		return file.good();
+	}
+
+	void makeDirectory(const std::string &path)
+	{
+#ifdef _WIN32
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0755);
+#endif
+	}
+
+	std::vector<std::string> listFiles(const std::string &dir, const std::string &extension)
+	{
+		std::vector<std::string> files;
+#ifdef _WIN32
+		WIN32_FIND_DATAA findData;
+		HANDLE hFind = FindFirstFileA((dir + "/*" + extension).c_str(), &findData);
+		if (hFind == INVALID_HANDLE_VALUE) return files;
+		do { files.push_back(dir + "/" + findData.cFileName); } while (FindNextFileA(hFind, &findData));
+		FindClose(hFind);
+#else
+		DIR *pDir = opendir(dir.c_str());
+		if (!pDir) return files;
+		while (dirent *pEntry = readdir(pDir))
+		{
+			std::string name = pEntry->d_name;
+			if (name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0)
+				files.push_back(dir + "/" + name);
+		}
+		closedir(pDir);
+#endif
+		return files;
+	}
+};
+
+const uint32_t ShaderCache::kMagic;
+const uint32_t ShaderCache::kFormatVersion;
+
+ShaderCache::SharedPtr ShaderCache::create(const std::string &cacheDir, const std::vector<std::string> &includeDirs)
+{
+	return SharedPtr(new ShaderCache(cacheDir, includeDirs));
+}
+
+ShaderCache::ShaderCache(const std::string &cacheDir, const std::vector<std::string> &includeDirs)
+	: mCacheDir(cacheDir), mIncludeDirs(includeDirs)
+{
+	makeDirectory(mCacheDir);
+}
+
+std::vector<std::string> ShaderCache::findIncludes(const std::string &source)
+{
+	std::vector<std::string> includes;
+	std::istringstream lines(source);
+	std::string line;
+	while (std::getline(lines, line))
+	{
+		// Looking for:  [whitespace] # [whitespace] include [whitespace] "file" (or <file>)
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line[pos] != '#') continue;
+		pos = line.find_first_not_of(" \t", pos + 1);
+		if (pos == std::string::npos || line.compare(pos, 7, "include") != 0) continue;
+		pos = line.find_first_not_of(" \t", pos + 7);
+		if (pos == std::string::npos || (line[pos] != '"' && line[pos] != '<')) continue;
+
+		char close = (line[pos] == '"') ? '"' : '>';
+		size_t end = line.find(close, pos + 1);
+		if (end != std::string::npos && end > pos + 1)
+			includes.push_back(line.substr(pos + 1, end - pos - 1));
+	}
+	return includes;
+}
+
+std::string ShaderCache::resolveInclude(const std::string &includingFile, const std::string &include) const
+{
+	std::string local = directoryOf(includingFile) + include;
+	if (fileExists(local)) return local;
+
+	for (auto &dir : mIncludeDirs)
+	{
+		std::string candidate = dir + "/" + include;
+		if (fileExists(candidate)) return candidate;
+	}
+	return std::string();
+}
+
+bool ShaderCache::hashFileAndIncludes(const std::string &path, std::vector<std::string> &visited, Key &key, uint64_t &hash) const
+{
+	std::string contents;
+	if (!readFile(path, contents)) return false;
+	visited.push_back(path);
+	key.dependencies.push_back(path);
+
+	// Hash the name (not the full path, so moving the whole tree doesn't invalidate the cache) and contents
+	hash = hashString(fileNameOf(path), hash);
+	hash = hashString(contents, hash);
+
+	for (auto &include : findIncludes(contents))
+	{
+		hash = hashString(include, hash);
+
+		std::string resolved = resolveInclude(path, include);
+		if (resolved.empty())
+		{
+			// Probably a compiler-provided header.  We can't see it, so its name is all we can hash
+			if (std::find(key.unresolved.begin(), key.unresolved.end(), include) == key.unresolved.end())
+				key.unresolved.push_back(include);
+			continue;
+		}
+
+		// Files included more than once only contribute their contents the first time
+		if (std::find(visited.begin(), visited.end(), resolved) != visited.end()) continue;
+		if (!hashFileAndIncludes(resolved, visited, key, hash)) return false;
+	}
+	return true;
+}
+
+ShaderCache::Key ShaderCache::computeKey(const ProgramDesc &desc) const
+{
+	Key key;
+	uint64_t hash = Fnv1a::hashBytes(&kFormatVersion, sizeof(kFormatVersion));
+
+	std::vector<std::string> visited;
+	for (auto &source : desc.sourceFiles)
+	{
+		// Sources not found as specified are searched for in our include directories (e.g., Falcor's data directories)
+		std::string path = resolveInclude(std::string(), source);
+		if (path.empty() || !hashFileAndIncludes(path, visited, key, hash))
+			return key;   // Not valid; a source is missing
+	}
+
+	// #defines are an unordered set, so sort them for a stable hash
+	auto defines = desc.defines;
+	std::sort(defines.begin(), defines.end());
+	for (auto &define : defines)
+	{
+		hash = hashString(define.first, hash);
+		hash = hashString(define.second, hash);
+	}
+
+	// ...but entry point order matters (it determines things like hit group indices)
+	for (auto &entry : desc.entryPoints)
+		hash = hashString(entry, hash);
+	hash = hashString(desc.target, hash);
+
+	key.hash = hash;
+	key.valid = true;
+	return key;
+}
+
+std::string ShaderCache::getEntryPath(const Key &key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)key.hash);
+	return mCacheDir + "/" + name + kEntryExtension;
+}
+
+std::vector<uint8_t> ShaderCache::serializeEntry(uint64_t keyHash, const std::vector<uint8_t> &blob)
+{
+	uint64_t payloadSize = blob.size();
+	uint64_t payloadHash = Fnv1a::hashBytes(blob.data(), blob.size());
+
+	std::vector<uint8_t> entry;
+	entry.reserve(kHeaderSize + blob.size());
+	appendBytes(entry, &kMagic, sizeof(kMagic));
+	appendBytes(entry, &kFormatVersion, sizeof(kFormatVersion));
+	appendBytes(entry, &keyHash, sizeof(keyHash));
+	appendBytes(entry, &payloadSize, sizeof(payloadSize));
+	appendBytes(entry, &payloadHash, sizeof(payloadHash));
+	entry.insert(entry.end(), blob.begin(), blob.end());
+	return entry;
+}
+
+bool ShaderCache::deserializeEntry(const std::vector<uint8_t> &entry, uint64_t expectedKeyHash, std::vector<uint8_t> &blob)
+{
+	if (entry.size() < kHeaderSize) return false;
+	if (readValue<uint32_t>(entry, 0) != kMagic) return false;
+	if (readValue<uint32_t>(entry, 4) != kFormatVersion) return false;
+	if (readValue<uint64_t>(entry, 8) != expectedKeyHash) return false;
+
+	uint64_t payloadSize = readValue<uint64_t>(entry, 16);
+	uint64_t payloadHash = readValue<uint64_t>(entry, 24);
+	if (payloadSize != entry.size() - kHeaderSize) return false;
+	if (payloadHash != Fnv1a::hashBytes(entry.data() + kHeaderSize, size_t(payloadSize))) return false;
+
+	blob.assign(entry.begin() + kHeaderSize, entry.end());
+	return true;
+}
+
+bool ShaderCache::load(const Key &key, std::vector<uint8_t> &blob)
+{
+	if (!key.valid) return false;
+
+	std::string path = getEntryPath(key);
+	std::ifstream file(path, std::ios::binary);
+	if (!file.good())
+	{
+		std::lock_guard<std::mutex> lock(mStatsMutex);
+		mStats.misses++;
+		return false;
+	}
+	std::vector<uint8_t> entry((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+
+	if (!deserializeEntry(entry, key.hash, blob))
+	{
+		// Don't let a bad entry cost us a read on every launch; it'll get rewritten after the recompile
+		std::remove(path.c_str());
+		std::lock_guard<std::mutex> lock(mStatsMutex);
+		mStats.rejected++;
+		mStats.misses++;
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+	mStats.hits++;
+	return true;
+}
+
+bool ShaderCache::store(const Key &key, const std::vector<uint8_t> &blob)
+{
+	if (!key.valid) return false;
+
+	std::string path = getEntryPath(key);
+	static std::atomic<uint32_t> sNextTempId { 0 };
+	std::string tempPath = path + "." + std::to_string(sNextTempId++) + ".tmp";   // Unique, in case two threads store the same key
+	std::vector<uint8_t> entry = serializeEntry(key.hash, blob);
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.good()) return false;
+		file.write(reinterpret_cast<const char*>(entry.data()), entry.size());
+		if (!file.good()) return false;
+	}
+
+	// rename() won't replace an existing file on Windows
+	std::remove(path.c_str());
+	if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+	mStats.stores++;
+	return true;
+}
+
+void ShaderCache::clear()
+{
+	for (auto &file : listFiles(mCacheDir, kEntryExtension))
+		std::remove(file.c_str());
+}
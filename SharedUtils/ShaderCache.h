@@ -0,0 +1,155 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** A content-addressed, on-disk cache of compiled shader programs.
+
+Entries are keyed by a hash of everything that determines a program's bytecode:  the contents of each
+source file *and* everything it (transitively) #includes, the #defines, the entry points, and the compile
+target.  Editing any of these gives a new key, so stale entries are never returned (they're simply never
+looked up again; clear() removes them).  Each entry is one file, named by its key, holding a small header
+(magic, format version, key, payload size and hash) followed by the compiled blob.  Truncated, corrupt or
+old-format entries are rejected and deleted.
+
+This class deliberately has no Falcor (or D3D) dependencies, so keying, invalidation and the file format
+can be built and tested standalone.  computeKey(), load() and store() may be called from worker threads.
+
+RayLaunch keys every program it builds with this cache (see RayLaunch::setShaderCache()).  Falcor 3.1 can't
+create a program from precompiled bytecode, so rather than bytecode it stores a record of each program whose
+creation threw:  that program isn't retried with these exact sources and #defines.
+SceneRegistry keeps the acceleration structure build flags each scene file called for in a cache, too.
+
+Usage:
+     ShaderCache::SharedPtr pCache = ShaderCache::create("ShaderCache", getDataDirectoriesList());
+
+     ShaderCache::ProgramDesc desc;
+     desc.sourceFiles = { "myShader.ps.hlsl" };
+     desc.entryPoints = { "main" };
+     desc.defines     = { { "MY_DEFINE", "1" } };
+     desc.target      = "ps_6_1";
+
+     ShaderCache::Key key = pCache->computeKey(desc);
+     std::vector<uint8_t> blob;
+     if (!pCache->load(key, blob))      // Warm start?
+     {
+          blob = compileMyProgram();     // Nope.  Compile and remember the result
+          pCache->store(key, blob);
+     }
+*/
+class ShaderCache : public std::enable_shared_from_this<ShaderCache>
+{
+public:
+	using SharedPtr = std::shared_ptr<ShaderCache>;
+	using SharedConstPtr = std::shared_ptr<const ShaderCache>;
+	virtual ~ShaderCache() = default;
+
+	// Everything (beyond file contents) that determines a compiled program
+	struct ProgramDesc
+	{
+		std::vector<std::string>                          sourceFiles;   ///< Program source files (if not found, searched for in the include dirs)
+		std::vector<std::string>                          entryPoints;
+		std::vector<std::pair<std::string, std::string>>  defines;       ///< Order doesn't matter; they're sorted when hashed
+		std::string                                       target;        ///< Shader model, compiler flags, etc.
+
+		// Helpers to keep a description in sync as a program is built up
+		void addSourceFile(const std::string &file)
+		{
+			if (std::find(sourceFiles.begin(), sourceFiles.end(), file) == sourceFiles.end()) sourceFiles.push_back(file);
+		}
+		void addDefine(const std::string &name, const std::string &value)
+		{
+			removeDefine(name);
+			defines.push_back(std::make_pair(name, value));
+		}
+		void removeDefine(const std::string &name)
+		{
+			defines.erase(std::remove_if(defines.begin(), defines.end(), [&](const std::pair<std::string, std::string> &d) { return d.first == name; }), defines.end());
+		}
+	};
+
+	// The result of hashing a program and its dependencies
+	struct Key
+	{
+		uint64_t                  hash = 0;
+		std::vector<std::string>  dependencies;   ///< Every file hashed (sources plus resolved #includes)
+		std::vector<std::string>  unresolved;     ///< #includes we couldn't find (hashed by name only)
+		bool                      valid = false;  ///< False if a source file couldn't be read
+	};
+
+	struct Stats
+	{
+		uint32_t hits = 0;
+		uint32_t misses = 0;
+		uint32_t rejected = 0;   ///< Entries found, but corrupt or from an older format (and deleted)
+		uint32_t stores = 0;
+	};
+
+	// Entry files start with these, so we never load garbage (or an entry written by an incompatible version)
+	static const uint32_t kMagic = 0x43444853u;   // "SHDC"
+	static const uint32_t kFormatVersion = 1u;
+
+	// Create a cache storing entries in cacheDir (created if needed).  Includes that aren't relative to
+	//     the including file are searched for in includeDirs.
+	static SharedPtr create(const std::string &cacheDir, const std::vector<std::string> &includeDirs = {});
+
+	// Hash a program's sources, includes, defines, entry points and target
+	Key computeKey(const ProgramDesc &desc) const;
+
+	// Load a previously stored blob.  Returns false on a miss (or if the entry was bad)
+	bool load(const Key &key, std::vector<uint8_t> &blob);
+
+	// Store a compiled blob.  Written to a temporary file then renamed, so readers never see partial entries
+	bool store(const Key &key, const std::vector<uint8_t> &blob);
+
+	// Delete every entry in the cache directory
+	void clear();
+
+	// Where an entry with the specified key lives on disk
+	std::string getEntryPath(const Key &key) const;
+
+	Stats getStats() const { std::lock_guard<std::mutex> lock(mStatsMutex); return mStats; }
+
+	// The entry file format, exposed separately so it can be tested without touching the disk
+	static std::vector<uint8_t> serializeEntry(uint64_t keyHash, const std::vector<uint8_t> &blob);
+	static bool deserializeEntry(const std::vector<uint8_t> &entry, uint64_t expectedKeyHash, std::vector<uint8_t> &blob);
+
+	// Find the targets of the #include directives in some shader source
+	static std::vector<std::string> findIncludes(const std::string &source);
+
+protected:
+	ShaderCache(const std::string &cacheDir, const std::vector<std::string> &includeDirs);
+
+	// Hash a file and, recursively, everything it includes.  Returns false if the file can't be read
+	bool hashFileAndIncludes(const std::string &path, std::vector<std::string> &visited, Key &key, uint64_t &hash) const;
+
+	// Where does an #include from the specified file point to?  Returns "" if not found
+	std::string resolveInclude(const std::string &includingFile, const std::string &include) const;
+
+	std::string               mCacheDir;
+	std::vector<std::string>  mIncludeDirs;
+	Stats                     mStats;
+	mutable std::mutex        mStatsMutex;      ///< Guards mStats, as loads and stores may come from several threads
+};
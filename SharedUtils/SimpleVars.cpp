@@ -32,7 +32,9 @@ SimpleVars::SharedPtr SimpleVars::SimpleVars::create(Falcor::GraphicsVars *pVars
 
 SimpleVars::SimpleVars(Falcor::GraphicsVars *pVars)
 {
+	static uint64_t sNextUniqueId = 1;
 	mpVars = pVars;
+	mUniqueId = sNextUniqueId++;
 }
 
 #if 0
@@ -87,6 +89,42 @@ bool SimpleVars::setRawBuffer(const std::string& name, Falcor::Buffer::SharedPtr
 	return mpVars->setRawBuffer(name, pBuffer);
 }
 
+void SimpleVars::resolve(Binding& binding)
+{
+	binding.mResolvedFor = mUniqueId;
+	binding.mpCB = nullptr;
+	binding.mOffset = VariablesBuffer::kInvalidOffset;
+	binding.mIsTexture = false;
+	if (!mpVars) return;
+
+	// Constant buffer variables resolve to a buffer and an offset into it
+	if (!binding.mCBufName.empty())
+	{
+		binding.mpCB = mpVars->getConstantBuffer(binding.mCBufName).get();
+		if (binding.mpCB) binding.mOffset = binding.mpCB->getVariableOffset(binding.mVarName);
+		return;
+	}
+
+	// Textures resolve to a register slot (and whether they're bound as a SRV or UAV)
+	if (!isVarValid(binding.mVarName, ReflectionResourceType::Type::Texture)) return;
+	ReflectionVar::SharedConstPtr pRes = mpVars->getReflection()->getResource(binding.mVarName);
+	const ReflectionResourceType* pType = pRes->getType()->unwrapArray()->asResourceType();
+	binding.mIsTexture = true;
+	binding.mIsUav = (pType->getShaderAccess() == ReflectionResourceType::ShaderAccess::ReadWrite);
+	binding.mRegSpace = pRes->getRegisterSpace();
+	binding.mRegIndex = pRes->getRegisterIndex();
+}
+
+bool SimpleVars::setTexture(Binding& binding, const Texture::SharedPtr& pTexture)
+{
+	if (!binding.isResolvedFor(this)) resolve(binding);
+	if (!binding.mIsTexture) return false;
+
+	if (binding.mIsUav)
+		return mpVars->setUav(binding.mRegSpace, binding.mRegIndex, 0, pTexture ? pTexture->getUAV() : nullptr);
+	return mpVars->setSrv(binding.mRegSpace, binding.mRegIndex, 0, pTexture ? pTexture->getSRV() : nullptr);
+}
+
 bool SimpleVars::isVarValid(const std::string &varName, ReflectionResourceType::Type varType)
 {
 	ReflectionVar::SharedConstPtr mRes = mpVars->getReflection()->getResource(varName);
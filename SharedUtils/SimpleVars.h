@@ -33,6 +33,15 @@ Usually usage of this class looks as follows:
 	hlslVars["myTexture"] = myTextureResource;
 	hlslVars["myBuffer"]  = myBufferResource;
 
+Assignments like these look up the constant buffer and variable (or query the shader reflection) by name
+every time they run.  For variables set every frame, resolve the binding once into a Binding member, and
+assign through that instead.  Bindings re-resolve themselves when used with a SimpleVars they haven't seen
+(e.g., after a pass wrapper recreates its vars because the program or scene changed):
+    SimpleVars::Binding mFrameCount{ "myShaderCB", "myFrameCount" };   // Class members
+    SimpleVars::Binding mTexture{ "myTexture" };
+	hlslVars[mFrameCount] = frameCount++;                             // Each frame
+	hlslVars[mTexture] = myTextureResource;
+
 This functionality is consistent across all wrappers and shader types that use SimpleVars.  You can
 also use more Falcor-like syntax if you just want this class' beefed up error checking:
     hlslVars->setVariable("myShaderCB","myUint4Var", uint4(1, 2, 4, 16));
@@ -48,10 +57,57 @@ class SimpleVars : public std::enable_shared_from_this<SimpleVars>
 {
 public:
 
+	// A shader variable (in a constant buffer) or resource, resolved to a buffer offset or register slot the first time
+	//    it's used with a given SimpleVars.  See the usage comment above.
+	class Binding
+	{
+	public:
+		explicit Binding(const std::string& resourceName) : mVarName(resourceName) {}
+		Binding(const std::string& cBufName, const std::string& varName) : mCBufName(cBufName), mVarName(varName) {}
+
+		// Is this binding resolved against the specified vars?
+		bool isResolvedFor(const SimpleVars* pVars) const { return pVars && mResolvedFor == pVars->mUniqueId; }
+
+	protected:
+		friend class SimpleVars;
+		std::string              mCBufName;                ///< Empty for textures
+		std::string              mVarName;
+		uint64_t                 mResolvedFor = 0;         ///< SimpleVars::mUniqueId of the vars we resolved against (0 = never)
+
+		// Resolved constant buffer variable
+		Falcor::ConstantBuffer*  mpCB = nullptr;
+		size_t                   mOffset = Falcor::VariablesBuffer::kInvalidOffset;
+
+		// Resolved texture slot
+		bool                     mIsTexture = false;
+		bool                     mIsUav = false;
+		uint32_t                 mRegSpace = 0;
+		uint32_t                 mRegIndex = 0;
+	};
+
 	// This class uses an overloaded shared_ptr that allows calling array operations.
 	class SharedPtr : public std::shared_ptr<SimpleVars>
 	{
 	public:
+		// An intermediary class that allows assignment through a Binding, i.e., mySharedPtr[myBinding] = someValue;
+		class BoundVar
+		{
+		public:
+			BoundVar(SimpleVars* pBuf, Binding& binding) : mpBuf(pBuf), mBinding(binding) { if (mpBuf && !binding.isResolvedFor(mpBuf)) mpBuf->resolve(binding); }
+
+			// Set constant buffer variables
+			template<typename T> void operator=(const T& val) { if (isVariable()) { mBinding.mpCB->setVariable(mBinding.mOffset, val); } }
+			template<typename T> void setBlob(const T& blob) { if (isVariable()) { mBinding.mpCB->setBlob(&blob, mBinding.mOffset, sizeof(T)); } }
+
+			// Set textures
+			void operator=(const Falcor::Texture::SharedPtr& pTexture) { if (mpBuf) { mpBuf->setTexture(mBinding, pTexture); } }
+
+		protected:
+			bool isVariable() const { return mpBuf && mBinding.mpCB && mBinding.mOffset != Falcor::VariablesBuffer::kInvalidOffset; }
+			SimpleVars* mpBuf;
+			Binding&    mBinding;
+		};
+
 
 		// A secondary intermediary class that allows a double [][] operator to be used on the SharedPtr.
 		class Var
@@ -112,6 +168,9 @@ public:
 
 		// Calling [] on the SharedPtr?  Create an intermediate object to process further operators
 		Idx1 operator[](const std::string& var) { return Idx1(get(), var); }
+
+		// Calling [] with a Binding?  Resolve it (if needed) and skip the name lookups
+		BoundVar operator[](Binding& binding) { return BoundVar(get(), binding); }
 	};
 
 	// public constructors
@@ -140,6 +199,15 @@ public:
 	bool setStructuredBuffer(const std::string& name, Falcor::StructuredBuffer::SharedPtr& pBuffer);
 	bool setRawBuffer(const std::string& name, Falcor::Buffer::SharedPtr& pBuffer);
 
+	// Set a texture via a pre-resolved binding.  Returns false if the binding doesn't name a texture in these vars.
+	bool setTexture(Binding& binding, const Falcor::Texture::SharedPtr& pTexture);
+
+	// Look up a binding's buffer offset or register slot in these vars.  (Done automatically on first use.)
+	void resolve(Binding& binding);
+
+	// An id unique to this SimpleVars (never reused), so callers caching state derived from our vars know when it's stale
+	uint64_t getUniqueId() const { return mUniqueId; }
+
 	// Get the current underlying Falcor variable class
 	Falcor::GraphicsVars *getVars()
 	{	
@@ -151,6 +219,7 @@ protected:
 
 private:
 	Falcor::GraphicsVars*   mpVars = nullptr;
+	uint64_t                mUniqueId;       ///< Never reused, so Bindings can tell when they're used with new vars
 
 	// Internal utility function that does additional error checking beyond Falcor's built-in checks
 	//    -> returns true if shader variable [varName] exists and has type [varType]
@@ -0,0 +1,128 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "TransientAliasPlanner.h"
+#include <algorithm>
+
+void TransientAliasPlanner::clear()
+{
+	mResources.clear();
+}
+
+uint32_t TransientAliasPlanner::addResource(const std::string& name, const AliasKey& key, uint64_t byteSize, bool isPinned)
+{
+	Resource res;
+	res.name = name;
+	res.key = key;
+	res.byteSize = byteSize;
+	res.isPinned = isPinned;
+	res.aliasTarget = uint32_t(mResources.size());
+
+	mResources.push_back(res);
+	return uint32_t(mResources.size() - 1);
+}
+
+int32_t TransientAliasPlanner::findResource(const std::string& name) const
+{
+	for (uint32_t i = 0; i < mResources.size(); i++)
+	{
+		if (mResources[i].name == name) return int32_t(i);
+	}
+	return -1;
+}
+
+void TransientAliasPlanner::addUse(const std::string& name, uint32_t step, bool isWrite)
+{
+	int32_t resIdx = findResource(name);
+	if (resIdx < 0) return;
+
+	Resource& res = mResources[resIdx];
+	if (res.firstUse == kUnused)
+	{
+		res.firstUse = step;
+		res.firstUseIsRead = !isWrite;
+	}
+	res.lastUse = step;
+}
+
+uint32_t TransientAliasPlanner::plan()
+{
+	// Consider resources in order of when they start living.  Unused resources live all frame (and so are pinned).
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < mResources.size(); i++)
+	{
+		mResources[i].aliasTarget = i;
+		order.push_back(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return mResources[a].firstUse < mResources[b].firstUse; });
+
+	std::vector<Slot> slots;
+	uint32_t pinnedCount = 0;
+	for (uint32_t resIdx : order)
+	{
+		Resource& res = mResources[resIdx];
+		if (isPinned(resIdx))
+		{
+			pinnedCount++;
+			continue;
+		}
+
+		// Reuse a compatible slot whose last user is done strictly before we start (a pass reading one
+		//    resource while writing another needs both to exist simultaneously).
+		Slot* pSlot = nullptr;
+		for (auto& slot : slots)
+		{
+			if (slot.key == res.key && slot.lastUse < res.firstUse)
+			{
+				pSlot = &slot;
+				break;
+			}
+		}
+
+		if (pSlot)
+		{
+			res.aliasTarget = pSlot->owner;
+			pSlot->lastUse = res.lastUse;
+		}
+		else
+		{
+			slots.push_back({ res.key, resIdx, res.lastUse });
+		}
+	}
+
+	return uint32_t(slots.size()) + pinnedCount;
+}
+
+uint64_t TransientAliasPlanner::getUnaliasedBytes() const
+{
+	uint64_t bytes = 0;
+	for (auto& res : mResources)
+		bytes += res.byteSize;
+	return bytes;
+}
+
+uint64_t TransientAliasPlanner::getAliasedBytes() const
+{
+	// Only resources that own their memory count
+	uint64_t bytes = 0;
+	for (uint32_t i = 0; i < mResources.size(); i++)
+	{
+		if (mResources[i].aliasTarget == i) bytes += mResources[i].byteSize;
+	}
+	return bytes;
+}
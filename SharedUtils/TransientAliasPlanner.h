@@ -0,0 +1,110 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Plans which ResourceManager channels can share backing memory within a frame.
+
+Each resource is described by a compatibility key (format, bind flags, size) and its byte size.  The
+pipeline then reports every use of each resource by step (i.e., position in the pass execution order).
+plan() computes each resource's live range [first use, last use] and greedily assigns resources with
+identical keys and non-overlapping live ranges to the same physical allocation.
+
+Resources are never aliased if they are pinned (e.g., the pipeline output or externally managed textures)
+or if their first use in a frame is a read (meaning they carry data from the prior frame).  Resources no
+pass uses this frame are treated as live for the whole frame, since their contents may be persistent 
+(e.g., a channel only a culled or temporarily skipped pass writes), so they keep their own memory, too.
+
+This class does not touch Falcor or the GPU, so it can be exercised without a device.
+*/
+class TransientAliasPlanner
+{
+public:
+	// Two resources can only share memory if their keys match exactly.  Width or height of -1 means "screen sized"
+	struct AliasKey
+	{
+		uint32_t format = 0;
+		uint32_t bindFlags = 0;
+		int32_t  width = -1;
+		int32_t  height = -1;
+
+		bool operator==(const AliasKey& other) const
+		{
+			return format == other.format && bindFlags == other.bindFlags && width == other.width && height == other.height;
+		}
+	};
+
+	TransientAliasPlanner() = default;
+
+	// Remove all resources and uses
+	void clear();
+
+	// Add a resource.  Returns its index (resources are indexed in the order added).
+	uint32_t addResource(const std::string& name, const AliasKey& key, uint64_t byteSize, bool isPinned = false);
+
+	// Note that the pass executing at <step> reads or writes the named resource.  Steps must be added in 
+	//    non-decreasing order; within one step, add reads before writes.  Unknown names are ignored.
+	void addUse(const std::string& name, uint32_t step, bool isWrite);
+
+	// Assigns each resource to a physical allocation.  Returns the number of allocations needed.
+	uint32_t plan();
+
+	// Queries on the last plan()
+	uint32_t getResourceCount() const                  { return uint32_t(mResources.size()); }
+	const std::string& getName(uint32_t resIdx) const  { return mResources[resIdx].name; }
+	bool     isPinned(uint32_t resIdx) const           { return mResources[resIdx].isPinned || mResources[resIdx].firstUseIsRead || !isUsed(resIdx); }
+	bool     isUsed(uint32_t resIdx) const             { return mResources[resIdx].firstUse != kUnused; }
+
+	// Which resource owns the memory this resource uses?  (Returns resIdx itself if it is not aliased.)
+	uint32_t getAliasTarget(uint32_t resIdx) const     { return mResources[resIdx].aliasTarget; }
+
+	// Memory statistics:  without aliasing, with aliasing, and the difference
+	uint64_t getUnaliasedBytes() const;
+	uint64_t getAliasedBytes() const;
+	uint64_t getBytesSaved() const                     { return getUnaliasedBytes() - getAliasedBytes(); }
+
+protected:
+	static const uint32_t kUnused = 0xFFFFFFFFu;
+
+	struct Resource
+	{
+		std::string  name;
+		AliasKey     key;
+		uint64_t     byteSize = 0;
+		bool         isPinned = false;
+		bool         firstUseIsRead = false;   ///< First use this frame is a read, so it carries data between frames
+		uint32_t     firstUse = kUnused;       ///< First step at which the resource is used
+		uint32_t     lastUse = kUnused;        ///< Last step at which the resource is used
+		uint32_t     aliasTarget = 0;          ///< Filled by plan()
+	};
+
+	// A physical allocation shared by one or more resources
+	struct Slot
+	{
+		AliasKey     key;
+		uint32_t     owner;                    ///< Resource whose memory is shared
+		uint32_t     lastUse;                  ///< Last step at which any resource in this slot is used
+	};
+
+	int32_t findResource(const std::string& name) const;
+
+	std::vector<Resource>  mResources;
+};
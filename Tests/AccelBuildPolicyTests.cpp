@@ -0,0 +1,127 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "AccelBuildPolicy.h"
+#include "TestHarness.h"
+#include <string>
+
+using Policy = AccelBuildPolicy;
+
+namespace {
+	const uint32_t kStatic = Policy::FastTrace | Policy::AllowCompaction;
+	const uint32_t kDeforming = Policy::FastBuild | Policy::AllowUpdate;
+
+	Policy::SceneDesc makeStaticScene()
+	{
+		Policy::SceneDesc desc;
+		desc.meshes = { { false, 1000 }, { false, 500 } };
+		return desc;
+	}
+};
+
+// Nothing moves:  everything is built once for fast traces
+void testStaticScene()
+{
+	Policy::Selection sel = Policy::select(makeStaticScene(), Policy::Mode::Automatic);
+	CHECK(sel.meshFlags.size() == 2 && sel.meshFlags[0] == kStatic && sel.meshFlags[1] == kStatic);
+	CHECK(sel.sceneFlags == Policy::FastTrace);
+	CHECK(sel.combinedFlags == kStatic);
+	CHECK(sel.staticMeshes == 2 && sel.deformingMeshes == 0 && !sel.dynamicInstances);
+
+	// An empty scene is static too
+	CHECK(Policy::select(Policy::SceneDesc(), Policy::Mode::Automatic).combinedFlags == kStatic);
+}
+
+// A camera path moves no geometry; object paths and animations rebuild (or update) the top level, but not the meshes
+void testMovingInstances()
+{
+	Policy::SceneDesc desc = makeStaticScene();
+	desc.hasCameraPath = true;
+	Policy::Selection sel = Policy::select(desc, Policy::Mode::Automatic);
+	CHECK(!sel.dynamicInstances && sel.sceneFlags == Policy::FastTrace);
+
+	desc.hasObjectPaths = true;
+	sel = Policy::select(desc, Policy::Mode::Automatic);
+	CHECK(sel.dynamicInstances && sel.sceneFlags == kDeforming);
+	CHECK(sel.meshFlags[0] == kStatic && sel.combinedFlags == (kStatic | Policy::AllowUpdate));
+
+	desc.hasObjectPaths = false;
+	desc.hasAnimations = true;
+	sel = Policy::select(desc, Policy::Mode::Automatic);
+	CHECK(sel.sceneFlags == kDeforming && sel.combinedFlags == (kStatic | Policy::AllowUpdate));
+	CHECK(Policy::select(desc, Policy::Mode::PreferFastBuild).combinedFlags == kDeforming);
+}
+
+// Deforming meshes get fast, updatable builds; the combined flags follow whichever kind has more triangles
+void testDeformingMeshes()
+{
+	Policy::SceneDesc desc = makeStaticScene();
+	desc.meshes.push_back({ true, 100 });
+	Policy::Selection sel = Policy::select(desc, Policy::Mode::Automatic);
+	CHECK(sel.meshFlags[2] == kDeforming);
+	CHECK(sel.staticMeshes == 2 && sel.deformingMeshes == 1 && sel.dynamicInstances);
+	CHECK(sel.sceneFlags == kDeforming);
+	CHECK(sel.combinedFlags == (kStatic | Policy::AllowUpdate));
+
+	desc.meshes[2].triangleCount = 5000;
+	CHECK(Policy::select(desc, Policy::Mode::Automatic).combinedFlags == kDeforming);
+
+	// A tie goes to the static geometry
+	desc.meshes[2].triangleCount = 1500;
+	CHECK(Policy::select(desc, Policy::Mode::Automatic).combinedFlags == (kStatic | Policy::AllowUpdate));
+}
+
+void testModes()
+{
+	Policy::SceneDesc desc = makeStaticScene();
+	desc.meshes.push_back({ true, 5000 });
+
+	Policy::Selection build = Policy::select(desc, Policy::Mode::PreferFastBuild);
+	CHECK(build.meshFlags[0] == Policy::FastBuild && build.meshFlags[2] == kDeforming);
+	CHECK(build.sceneFlags == kDeforming);
+	CHECK(build.combinedFlags == kDeforming);
+
+	Policy::Selection trace = Policy::select(desc, Policy::Mode::PreferFastTrace);
+	CHECK(trace.meshFlags[0] == kStatic && trace.meshFlags[2] == (Policy::FastTrace | Policy::AllowUpdate));
+	CHECK(trace.sceneFlags == (Policy::FastTrace | Policy::AllowUpdate));
+	CHECK(trace.combinedFlags == (kStatic | Policy::AllowUpdate));
+
+	// Without anything moving, neither mode allows updates on the top level
+	CHECK(Policy::select(makeStaticScene(), Policy::Mode::PreferFastBuild).sceneFlags == Policy::FastBuild);
+	CHECK(Policy::select(makeStaticScene(), Policy::Mode::PreferFastBuild).combinedFlags == Policy::FastBuild);
+	CHECK(Policy::select(makeStaticScene(), Policy::Mode::PreferFastTrace).sceneFlags == Policy::FastTrace);
+}
+
+void testToString()
+{
+	CHECK(Policy::toString(0u) == "None");
+	CHECK(Policy::toString(kStatic | Policy::AllowUpdate) == "AllowUpdate | AllowCompaction | FastTrace");
+	CHECK(Policy::toString(Policy::MinimizeMemory) == "MinimizeMemory");
+	CHECK(std::string(Policy::toString(Policy::Mode::Automatic)) == "Automatic");
+	CHECK(std::string(Policy::toString(Policy::Mode::PreferFastBuild)) == "Prefer fast build");
+}
+
+int main()
+{
+	testStaticScene();
+	testMovingInstances();
+	testDeformingMeshes();
+	testModes();
+	testToString();
+	return TestHarness::result("AccelBuildPolicyTests");
+}
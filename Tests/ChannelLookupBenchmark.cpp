@@ -0,0 +1,108 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "ChannelId.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Compares the per-frame cost of ResourceManager's two channel lookup paths, using the same data structures:
+    the old linear search over channel names (with a temporary std::string per call, as getTexture("...") builds),
+    and the ChannelId path (a precomputed hash resolved with one hash table lookup).  Each "frame" does the six 
+    lookups LightProbeGBufferPass::execute() does.  Pass an iteration count to run longer.
+*/
+
+namespace {
+	const char* kChannelNames[] = { "WorldPosition", "WorldNormal", "MaterialDiffuse", "MaterialSpecRough", "MaterialExtraParams",
+		"Emissive", "Z-Buffer", "HDRColorOutput", "EnvironmentMap", "PipelineOutput", "AOOutput", "HDRColorOutput::Accumulation" };
+
+	constexpr ChannelId kWorldPos("WorldPosition");
+	constexpr ChannelId kWorldNorm("WorldNormal");
+	constexpr ChannelId kMatDif("MaterialDiffuse");
+	constexpr ChannelId kMatSpec("MaterialSpecRough");
+	constexpr ChannelId kMatExtra("MaterialExtraParams");
+	constexpr ChannelId kEnvMap("EnvironmentMap");
+
+	struct ChannelTable
+	{
+		std::vector<std::string>              names;
+		std::unordered_map<uint64_t, int32_t> lookup;
+
+		int32_t findByString(const std::string& name) const
+		{
+			auto item = std::find(names.begin(), names.end(), name);
+			return (item == names.end()) ? -1 : int32_t(item - names.begin());
+		}
+
+		int32_t findById(const ChannelId& id) const
+		{
+			auto entry = lookup.find(id.getHash());
+			return (entry == lookup.end()) ? -1 : entry->second;
+		}
+	};
+
+	template <typename Fn> double nsPerFrame(uint32_t frames, Fn fn)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t i = 0; i < frames; i++) fn();
+		return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / frames;
+	}
+};
+
+int main(int argc, char** argv)
+{
+	uint32_t frames = (argc > 1) ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 200000u;
+	if (frames == 0) frames = 1;
+
+	ChannelTable table;
+	for (const char* name : kChannelNames)
+	{
+		table.lookup[ChannelId::hash(name)] = int32_t(table.names.size());
+		table.names.push_back(name);
+	}
+
+	// Both paths must agree before timing them means anything
+	const ChannelId ids[] = { kWorldPos, kWorldNorm, kMatDif, kMatSpec, kMatExtra, kEnvMap };
+	for (const ChannelId& id : ids)
+	{
+		if (table.findById(id) != table.findByString(id.getName()) || table.findById(id) < 0)
+		{
+			std::printf("ChannelLookupBenchmark: lookup mismatch for '%s'\n", id.getName());
+			return 1;
+		}
+	}
+
+	volatile int32_t sink = 0;
+	double stringNs = nsPerFrame(frames, [&]() {
+		sink = sink + table.findByString("WorldPosition") + table.findByString("WorldNormal") + table.findByString("MaterialDiffuse") +
+			table.findByString("MaterialSpecRough") + table.findByString("MaterialExtraParams") + table.findByString("EnvironmentMap");
+	});
+	double idNs = nsPerFrame(frames, [&]() {
+		sink = sink + table.findById(kWorldPos) + table.findById(kWorldNorm) + table.findById(kMatDif) +
+			table.findById(kMatSpec) + table.findById(kMatExtra) + table.findById(kEnvMap);
+	});
+
+	std::printf("ChannelLookupBenchmark (%u frames, 6 lookups/frame, %zu channels)\n", frames, table.names.size());
+	std::printf("  std::string linear search:  %8.1f ns/frame\n", stringNs);
+	std::printf("  ChannelId hash lookup:      %8.1f ns/frame  (%.1fx)\n", idNs, stringNs / idNs);
+	return 0;
+}
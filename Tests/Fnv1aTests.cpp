@@ -0,0 +1,58 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "Fnv1a.h"
+#include "ChannelId.h"
+#include "TestHarness.h"
+#include <cstring>
+
+// Published FNV-1a test vectors.  Cache files store these hashes, so they must never change.
+void testKnownValues()
+{
+	CHECK(Fnv1a::hashBytes("", 0) == 0xcbf29ce484222325ull);
+	CHECK(Fnv1a::hashBytes("a", 1) == 0xaf63dc4c8601ec8cull);
+	CHECK(Fnv1a::hashBytes("foobar", 6) == 0x85944171f73967e8ull);
+	static_assert(Fnv1a::hashString("foobar") == 0x85944171f73967e8ull, "constexpr string hash must match the published value");
+}
+
+// Hashing in pieces (seeding with the prior result) matches hashing everything at once
+void testIncrementalHashing()
+{
+	const char* str = "WorldPosition";
+	uint64_t whole = Fnv1a::hashBytes(str, strlen(str));
+	CHECK(Fnv1a::hashBytes(str + 5, strlen(str) - 5, Fnv1a::hashBytes(str, 5)) == whole);
+	CHECK(Fnv1a::hashString(str) == whole);
+}
+
+// ChannelIds hash exactly like the string lookups in ResourceManager do
+void testChannelIdUsesSharedHash()
+{
+	constexpr ChannelId kId("MaterialDiffuse");
+	static_assert(kId.getHash() == Fnv1a::hashString("MaterialDiffuse"), "ChannelId must use the shared FNV-1a");
+	CHECK(kId.getHash() == Fnv1a::hashBytes("MaterialDiffuse", strlen("MaterialDiffuse")));
+	CHECK(kId == ChannelId("MaterialDiffuse"));
+	CHECK(kId != ChannelId("MaterialSpecRough"));
+}
+
+int main()
+{
+	testKnownValues();
+	testIncrementalHashing();
+	testChannelIdUsesSharedHash();
+	return TestHarness::result("Fnv1aTests");
+}
@@ -0,0 +1,183 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "JobSystem.h"
+#include "TestHarness.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+
+using JobState = JobSystem::JobState;
+
+namespace {
+	// Holds a worker busy until released, so tests can control what's queued behind it
+	struct Gate
+	{
+		std::promise<void>        release;
+		std::shared_future<void>  opened = release.get_future().share();
+		std::function<void()> work() { auto opened = this->opened; return [opened]() { opened.wait(); }; }
+	};
+};
+
+void testJobsComplete()
+{
+	auto pJobs = JobSystem::create(2);
+	CHECK(pJobs->getThreadCount() == 2);
+
+	std::atomic<int> count { 0 };
+	std::vector<JobSystem::Job::SharedPtr> jobs;
+	for (int i = 0; i < 100; i++)
+		jobs.push_back(pJobs->submit([&count]() { count++; }));
+	pJobs->waitForIdle();
+
+	CHECK(count == 100);
+	CHECK(pJobs->getPendingCount() == 0);
+	for (auto &pJob : jobs)
+		CHECK(pJob->getState() == JobState::Completed && pJob->isFinished());
+}
+
+// Work that throws fails the job (with the exception's message), but not the pool
+void testJobsFail()
+{
+	auto pJobs = JobSystem::create(1);
+	auto pBad = pJobs->submit([]() { throw std::runtime_error("bad shader"); });
+	auto pGood = pJobs->submit([]() {});
+	pBad->wait();
+	pGood->wait();
+	CHECK(pBad->getState() == JobState::Failed && pBad->getError() == "bad shader");
+	CHECK(pGood->getState() == JobState::Completed && pGood->getError().empty());
+}
+
+// Queued jobs can be cancelled; running (or finished) ones can't
+void testCancel()
+{
+	auto pJobs = JobSystem::create(1);
+	Gate gate;
+	auto pBlocker = pJobs->submit(gate.work());
+	std::atomic<bool> ran { false };
+	auto pQueued = pJobs->submit([&ran]() { ran = true; });
+	auto pKept = pJobs->submit([]() {});
+
+	CHECK(pQueued->cancel());
+	CHECK(pQueued->getState() == JobState::Cancelled && pQueued->isFinished());
+	CHECK(!pQueued->cancel());
+
+	// Wait for the worker to pick up the blocker before trying to cancel it
+	while (pBlocker->getState() == JobState::Queued) std::this_thread::yield();
+	CHECK(!pBlocker->cancel());
+
+	gate.release.set_value();
+	pJobs->waitForIdle();
+	CHECK(pBlocker->getState() == JobState::Completed);
+	CHECK(pKept->getState() == JobState::Completed);
+	CHECK(!ran);
+	CHECK(!pKept->cancel());
+}
+
+// What RayLaunch's destructor does:  cancel(), then wait() for a job that was already running
+void testCancelThenWait()
+{
+	auto pJobs = JobSystem::create(1);
+	Gate gate;
+	std::atomic<bool> done { false };
+	auto opened = gate.opened;
+	auto pRunning = pJobs->submit([opened, &done]() { opened.wait(); done = true; });
+	while (pRunning->getState() == JobState::Queued) std::this_thread::yield();
+
+	auto releaser = std::async(std::launch::async, [&gate]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		gate.release.set_value();
+	});
+	CHECK(!pRunning->cancel());
+	pRunning->wait();
+	CHECK(done && pRunning->getState() == JobState::Completed);
+	releaser.wait();
+}
+
+// Destroying the pool cancels queued jobs and lets running ones finish, and jobs outlive it
+void testShutdown()
+{
+	auto pJobs = JobSystem::create(1);
+	Gate gate;
+	auto pRunning = pJobs->submit(gate.work());
+	auto pQueued = pJobs->submit([]() {});
+	while (pRunning->getState() == JobState::Queued) std::this_thread::yield();
+
+	auto releaser = std::async(std::launch::async, [&gate]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		gate.release.set_value();
+	});
+	pJobs = nullptr;
+	releaser.wait();
+
+	CHECK(pRunning->getState() == JobState::Completed);
+	CHECK(pQueued->getState() == JobState::Cancelled);
+	pQueued->cancel();    // Safe (and harmless) after the pool is gone...
+	pQueued->wait();      // ...as is waiting, which returns immediately
+}
+
+// The work (and whatever it captured) is released once a job finishes, however it finishes
+void testCapturesReleased()
+{
+	auto pJobs = JobSystem::create(1);
+	auto pCaptured = std::make_shared<int>(42);
+	std::weak_ptr<int> pWeak = pCaptured;
+
+	Gate gate;
+	auto pBlocker = pJobs->submit(gate.work());
+	auto pCancelled = pJobs->submit([pCaptured]() {});
+	auto pCompleted = pJobs->submit([pCaptured]() {});
+	pCaptured = nullptr;
+	pCancelled->cancel();
+	gate.release.set_value();
+	pJobs->waitForIdle();
+	CHECK(pWeak.expired());
+}
+
+// Prefetching reads each file in its own job; files we can't read fail theirs
+void testPrefetchFiles()
+{
+	{
+		std::ofstream file("JobSystemTests.bin", std::ios::binary | std::ios::trunc);
+		file << std::string(3000000, 'x');     // More than one read chunk
+	}
+
+	auto pJobs = JobSystem::create(2);
+	auto jobs = pJobs->prefetchFiles({ "JobSystemTests.bin", "JobSystemTests.Missing.bin" });
+	pJobs->waitForIdle();
+	CHECK(jobs.size() == 2);
+	CHECK(jobs[0]->getState() == JobState::Completed);
+	CHECK(jobs[1]->getState() == JobState::Failed && jobs[1]->getError().find("JobSystemTests.Missing.bin") != std::string::npos);
+	CHECK(pJobs->prefetchFiles({}).empty());
+	std::remove("JobSystemTests.bin");
+}
+
+int main()
+{
+	testJobsComplete();
+	testJobsFail();
+	testCancel();
+	testCancelThenWait();
+	testShutdown();
+	testCapturesReleased();
+	testPrefetchFiles();
+	return TestHarness::result("JobSystemTests");
+}
@@ -0,0 +1,221 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** A stand-in for the parts of Falcor that SimpleVars uses, so SimpleVars.cpp can be built and timed without a
+    device.  Name lookups go through std::maps, as Falcor's reflection does; setting data just writes to CPU memory.
+    Only the benchmark uses this -- it is not a general Falcor mock.
+*/
+
+namespace Falcor
+{
+	class VariablesBuffer
+	{
+	public:
+		static const size_t kInvalidOffset = size_t(-1);
+	};
+
+	class ConstantBuffer
+	{
+	public:
+		using SharedPtr = std::shared_ptr<ConstantBuffer>;
+
+		void addVariable(const std::string& name, size_t offset, size_t size)
+		{
+			mOffsets[name] = offset;
+			if (mData.size() < offset + size) mData.resize(offset + size);
+		}
+
+		size_t getVariableOffset(const std::string& name) const
+		{
+			auto var = mOffsets.find(name);
+			return (var == mOffsets.end()) ? VariablesBuffer::kInvalidOffset : var->second;
+		}
+
+		template<typename T> void setVariable(size_t offset, const T& value) { setBlob(&value, offset, sizeof(T)); }
+		template<typename T> void setVariable(const std::string& name, const T& value) { setVariable(getVariableOffset(name), value); }
+
+		void setBlob(const void* pSrc, size_t offset, size_t size)
+		{
+			if (offset == VariablesBuffer::kInvalidOffset || offset + size > mData.size()) return;
+			std::memcpy(mData.data() + offset, pSrc, size);
+		}
+
+		size_t getSize() const { return mData.size(); }
+
+	private:
+		std::map<std::string, size_t> mOffsets;
+		std::vector<uint8_t>          mData;
+	};
+
+	class ShaderResourceView {};
+	class UnorderedAccessView {};
+
+	class Texture
+	{
+	public:
+		using SharedPtr = std::shared_ptr<Texture>;
+		std::shared_ptr<ShaderResourceView> getSRV() { return mpSrv; }
+		std::shared_ptr<UnorderedAccessView> getUAV() { return mpUav; }
+	private:
+		std::shared_ptr<ShaderResourceView>  mpSrv = std::make_shared<ShaderResourceView>();
+		std::shared_ptr<UnorderedAccessView> mpUav = std::make_shared<UnorderedAccessView>();
+	};
+
+	class Sampler          { public: using SharedPtr = std::shared_ptr<Sampler>; };
+	class TypedBufferBase  { public: using SharedPtr = std::shared_ptr<TypedBufferBase>; };
+	class StructuredBuffer { public: using SharedPtr = std::shared_ptr<StructuredBuffer>; };
+	class Buffer           { public: using SharedPtr = std::shared_ptr<Buffer>; };
+
+	class ReflectionResourceType
+	{
+	public:
+		enum class Type { Texture, Sampler, TypedBuffer, StructuredBuffer, RawBuffer };
+		enum class ShaderAccess { Read, ReadWrite };
+
+		ReflectionResourceType(Type type, ShaderAccess access) : mType(type), mAccess(access) {}
+		Type getType() const { return mType; }
+		ShaderAccess getShaderAccess() const { return mAccess; }
+		const ReflectionResourceType* unwrapArray() const { return this; }
+		const ReflectionResourceType* asResourceType() const { return this; }
+
+	private:
+		Type         mType;
+		ShaderAccess mAccess;
+	};
+
+	class ReflectionVar
+	{
+	public:
+		using SharedConstPtr = std::shared_ptr<const ReflectionVar>;
+
+		ReflectionVar(ReflectionResourceType type, uint32_t regSpace, uint32_t regIndex) : mType(type), mRegSpace(regSpace), mRegIndex(regIndex) {}
+		const ReflectionResourceType* getType() const { return &mType; }
+		uint32_t getRegisterSpace() const { return mRegSpace; }
+		uint32_t getRegisterIndex() const { return mRegIndex; }
+
+	private:
+		ReflectionResourceType mType;
+		uint32_t               mRegSpace;
+		uint32_t               mRegIndex;
+	};
+
+	class ProgramReflection
+	{
+	public:
+		using SharedConstPtr = std::shared_ptr<const ProgramReflection>;
+
+		void addResource(const std::string& name, ReflectionVar::SharedConstPtr pVar) { mResources[name] = pVar; }
+
+		ReflectionVar::SharedConstPtr getResource(const std::string& name) const
+		{
+			auto res = mResources.find(name);
+			return (res == mResources.end()) ? nullptr : res->second;
+		}
+
+	private:
+		std::map<std::string, ReflectionVar::SharedConstPtr> mResources;
+	};
+
+	class ProgramVersion
+	{
+	public:
+		ProgramReflection::SharedConstPtr getReflector() const { return std::make_shared<ProgramReflection>(); }
+	};
+
+	class Program
+	{
+	public:
+		using SharedPtr = std::shared_ptr<Program>;
+		std::shared_ptr<const ProgramVersion> getActiveVersion() const { return std::make_shared<ProgramVersion>(); }
+	};
+
+	class GraphicsVars
+	{
+	public:
+		using SharedPtr = std::shared_ptr<GraphicsVars>;
+
+		GraphicsVars() : mpReflection(std::make_shared<ProgramReflection>()) {}
+		static SharedPtr create(const ProgramReflection::SharedConstPtr&) { return std::make_shared<GraphicsVars>(); }
+
+		// Setup, standing in for what Falcor builds from the program's reflection
+		ConstantBuffer::SharedPtr addConstantBuffer(const std::string& name)
+		{
+			return mConstantBuffers[name] = std::make_shared<ConstantBuffer>();
+		}
+		void addTexture(const std::string& name, uint32_t regIndex, bool isUav)
+		{
+			ReflectionResourceType type(ReflectionResourceType::Type::Texture, isUav ? ReflectionResourceType::ShaderAccess::ReadWrite : ReflectionResourceType::ShaderAccess::Read);
+			mpReflection->addResource(name, std::make_shared<ReflectionVar>(type, 0, regIndex));
+		}
+
+		ConstantBuffer::SharedPtr getConstantBuffer(const std::string& name) const
+		{
+			auto cb = mConstantBuffers.find(name);
+			return (cb == mConstantBuffers.end()) ? nullptr : cb->second;
+		}
+		ProgramReflection::SharedConstPtr getReflection() const { return mpReflection; }
+
+		bool setTexture(const std::string& name, const Texture::SharedPtr& pTexture)
+		{
+			ReflectionVar::SharedConstPtr pVar = mpReflection->getResource(name);
+			if (!pVar) return false;
+			if (pVar->getType()->getShaderAccess() == ReflectionResourceType::ShaderAccess::ReadWrite)
+				return setUav(pVar->getRegisterSpace(), pVar->getRegisterIndex(), 0, pTexture ? pTexture->getUAV() : nullptr);
+			return setSrv(pVar->getRegisterSpace(), pVar->getRegisterIndex(), 0, pTexture ? pTexture->getSRV() : nullptr);
+		}
+		bool setSampler(const std::string&, const Sampler::SharedPtr&) { return true; }
+		bool setTypedBuffer(const std::string&, TypedBufferBase::SharedPtr&) { return true; }
+		bool setStructuredBuffer(const std::string&, StructuredBuffer::SharedPtr&) { return true; }
+		bool setRawBuffer(const std::string&, Buffer::SharedPtr&) { return true; }
+
+		bool setSrv(uint32_t regSpace, uint32_t regIndex, uint32_t, const std::shared_ptr<ShaderResourceView>& pSrv)
+		{
+			slot(regSpace, regIndex) = pSrv.get();
+			return true;
+		}
+		bool setUav(uint32_t regSpace, uint32_t regIndex, uint32_t, const std::shared_ptr<UnorderedAccessView>& pUav)
+		{
+			slot(regSpace, regIndex) = pUav.get();
+			return true;
+		}
+
+		const void* getBoundView(uint32_t regSpace, uint32_t regIndex) { return slot(regSpace, regIndex); }
+
+	private:
+		const void*& slot(uint32_t regSpace, uint32_t regIndex)
+		{
+			size_t index = size_t(regSpace) * 64 + regIndex;
+			if (mViews.size() <= index) mViews.resize(index + 1, nullptr);
+			return mViews[index];
+		}
+
+		std::map<std::string, ConstantBuffer::SharedPtr> mConstantBuffers;
+		std::shared_ptr<ProgramReflection>               mpReflection;
+		std::vector<const void*>                         mViews;
+	};
+}
@@ -0,0 +1,179 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "OfflineFrameLoop.h"
+#include "TestHarness.h"
+
+namespace {
+	// Fails whichever backend call it's told to, so we can check the loop reports errors and stops
+	class FailingBackend : public NullOfflineBackend
+	{
+	public:
+		uint32_t failOnSample = 0xFFFFFFFFu;
+		bool     failWrite = false;
+
+		bool renderSample(uint32_t frameIdx, uint32_t sampleIdx) override
+		{
+			if (getSampleCount() == failOnSample) return false;
+			return NullOfflineBackend::renderSample(frameIdx, sampleIdx);
+		}
+		bool writeOutput(const std::string& filename) override
+		{
+			return !failWrite && NullOfflineBackend::writeOutput(filename);
+		}
+	};
+};
+
+// Three frames of four samples each:  12 samples, three files, animation time advancing per frame
+void testRendersEverySampleAndFrame()
+{
+	OfflineRenderSettings settings;
+	settings.sceneFile = "Data/scene.fscene";
+	settings.outputFile = "frame%d.png";
+	settings.frameCount = 3;
+	settings.samplesPerPixel = 4;
+	settings.secondsPerFrame = 0.5f;
+
+	NullOfflineBackend backend;
+	OfflineFrameLoop loop(settings, &backend);
+	CHECK(loop.run());
+	CHECK(loop.isDone());
+	CHECK(!loop.hasFailed());
+	CHECK(loop.getSamplesRendered() == 12);
+	CHECK(loop.getFramesWritten() == 3);
+
+	CHECK(backend.getSceneFile() == "Data/scene.fscene");
+	CHECK(!backend.wasCameraSet());
+	CHECK(backend.getSampleCount() == 12);
+	CHECK(backend.getAnimationTimes() == std::vector<float>({ 0.0f, 0.5f, 1.0f }));
+	CHECK(backend.getWrittenFiles() == std::vector<std::string>({ "frame0.png", "frame1.png", "frame2.png" }));
+}
+
+// Without a "%d," multiple frames get their number inserted before the extension
+void testOutputFilenames()
+{
+	OfflineRenderSettings settings;
+	settings.outputFile = "out/image.png";
+	settings.frameCount = 1;
+	CHECK(OfflineFrameLoop(settings, nullptr).getOutputFilename(0) == "out/image.png");
+
+	settings.frameCount = 2;
+	CHECK(OfflineFrameLoop(settings, nullptr).getOutputFilename(1) == "out/image.1.png");
+
+	settings.outputFile = "out.dir/image";
+	CHECK(OfflineFrameLoop(settings, nullptr).getOutputFilename(1) == "out.dir/image.1");
+}
+
+// step() drives the loop one sample at a time; each renderSample() "executes" the compiled graph
+void testStepRecordsGraphExecution()
+{
+	RenderGraph graph;
+	graph.addPass("G-Buffer", {}, { "WorldPosition" });
+	graph.addPass("Unused", {}, { "Scratch" }, { "Scratch" });
+	graph.addPass("Shade", { "WorldPosition" }, { "Output" }, { "Output" });
+	graph.compile("Output");
+
+	OfflineRenderSettings settings;
+	settings.outputFile = "image.exr";
+	settings.samplesPerPixel = 2;
+	settings.useSceneCamera = false;
+
+	NullOfflineBackend backend;
+	backend.setRenderGraph(graph);
+	OfflineFrameLoop loop(settings, &backend);
+	CHECK(loop.step());
+	CHECK(!loop.step());
+	CHECK(!loop.step());
+	CHECK(loop.getSamplesRendered() == 2);
+	CHECK(backend.wasCameraSet());
+	CHECK(backend.getExecutedPasses() == std::vector<std::string>({ "G-Buffer", "Shade", "G-Buffer", "Shade" }));
+}
+
+// Failures stop the loop and explain why
+void testFailures()
+{
+	OfflineRenderSettings settings;
+	settings.outputFile = "image.png";
+	settings.samplesPerPixel = 4;
+
+	CHECK(!OfflineFrameLoop(settings, nullptr).run());
+
+	OfflineRenderSettings noOutput;
+	NullOfflineBackend nullBackend;
+	OfflineFrameLoop noOutputLoop(noOutput, &nullBackend);
+	CHECK(!noOutputLoop.run());
+	CHECK(noOutputLoop.getError() == "No output file specified");
+
+	FailingBackend renderFails;
+	renderFails.failOnSample = 2;
+	OfflineFrameLoop renderLoop(settings, &renderFails);
+	CHECK(!renderLoop.run());
+	CHECK(renderLoop.hasFailed());
+	CHECK(renderLoop.getSamplesRendered() == 2);
+	CHECK(renderLoop.getFramesWritten() == 0);
+	CHECK(!renderLoop.getError().empty());
+
+	FailingBackend writeFails;
+	writeFails.failWrite = true;
+	OfflineFrameLoop writeLoop(settings, &writeFails);
+	CHECK(!writeLoop.run());
+	CHECK(writeLoop.getError() == "Unable to write 'image.png'");
+}
+
+void testParseCommandLine()
+{
+	OfflineRenderSettings settings;
+	std::string error;
+
+	CHECK(!parseOfflineCommandLine("", settings, error));
+	CHECK(error.empty());
+	CHECK(!parseOfflineCommandLine("--fullscreen", settings, error));
+	CHECK(error.empty());
+
+	CHECK(parseOfflineCommandLine("--offline \"my renders/frame%d.png\" --scene Data/a.fscene --frames 10 --spp 64 "
+		                          "--seconds-per-frame 0.25 --camera 1 2 3 0 0 -1", settings, error));
+	CHECK(error.empty());
+	CHECK(settings.outputFile == "my renders/frame%d.png");
+	CHECK(settings.sceneFile == "Data/a.fscene");
+	CHECK(settings.frameCount == 10);
+	CHECK(settings.samplesPerPixel == 64);
+	CHECK(settings.secondsPerFrame == 0.25f);
+	CHECK(!settings.useSceneCamera);
+	CHECK(settings.cameraPosition[1] == 2.0f && settings.cameraTarget[2] == -1.0f);
+
+	OfflineRenderSettings untouched;
+	CHECK(!parseOfflineCommandLine("--offline out.png --spp lots", untouched, error));
+	CHECK(error == "Invalid value for '--spp'");
+	CHECK(untouched.outputFile.empty());
+	CHECK(!parseOfflineCommandLine("--offline out.png --frames -2", untouched, error));
+	CHECK(!parseOfflineCommandLine("--offline out.png --camera 1 2 3", untouched, error));
+	CHECK(error == "Missing value for '--camera'");
+	CHECK(!parseOfflineCommandLine("--offline", untouched, error));
+	CHECK(!parseOfflineCommandLine("--offline out.png --bogus 1", untouched, error));
+	CHECK(error == "Unknown offline rendering argument '--bogus'");
+}
+
+int main()
+{
+	testRendersEverySampleAndFrame();
+	testOutputFilenames();
+	testStepRecordsGraphExecution();
+	testFailures();
+	testParseCommandLine();
+	return TestHarness::result("OfflineFrameLoopTests");
+}
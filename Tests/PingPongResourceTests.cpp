@@ -0,0 +1,102 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "PingPongResource.h"
+#include "TestHarness.h"
+#include <memory>
+
+namespace {
+	// Stands in for a texture:  just remembers the frame whose result it holds
+	struct MockTexture { int32_t frame = -1; };
+	using MockTexturePtr = std::shared_ptr<MockTexture>;
+};
+
+// Written pairs swap roles each frame, so last frame's result is readable without a copy
+void testSwapsAfterWrite()
+{
+	MockTexturePtr a = std::make_shared<MockTexture>(), b = std::make_shared<MockTexture>();
+	PingPongResource<MockTexturePtr> history;
+	history.reset(a, b);
+	CHECK(!history.hasValidHistory());
+	CHECK(history.getCurrent() == a);
+	CHECK(history.getPrevious() == b);
+	CHECK(history.getCurrentSlot() == 0);
+
+	for (int32_t frame = 0; frame < 4; frame++)
+	{
+		// An accumulation pass:  read last frame (if any), write this frame
+		if (frame > 0) CHECK(history.hasValidHistory() && history.getPrevious()->frame == frame - 1);
+		history.getCurrent()->frame = frame;
+		history.markWritten();
+		CHECK(history.endFrame());
+		CHECK(history.getCurrentSlot() == uint32_t((frame + 1) % 2));
+	}
+	CHECK(history.getPrevious()->frame == 3);
+	CHECK(history.getCurrent()->frame == 2);
+}
+
+// If the owning pass skips a frame, nothing swaps:  the previous result stays the previous result
+void testUnwrittenFramesDontSwap()
+{
+	MockTexturePtr a = std::make_shared<MockTexture>(), b = std::make_shared<MockTexture>();
+	PingPongResource<MockTexturePtr> history;
+	history.reset(a, b);
+
+	CHECK(!history.endFrame());
+	CHECK(!history.hasValidHistory());
+	CHECK(history.getCurrent() == a);
+
+	a->frame = 7;
+	history.markWritten();
+	CHECK(history.endFrame());
+	CHECK(!history.endFrame());
+	CHECK(!history.endFrame());
+	CHECK(history.hasValidHistory());
+	CHECK(history.getPrevious() == a && history.getPrevious()->frame == 7);
+}
+
+// invalidate() forgets contents without touching the resources; reset() replaces them and starts over
+void testInvalidateAndReset()
+{
+	MockTexturePtr a = std::make_shared<MockTexture>(), b = std::make_shared<MockTexture>();
+	PingPongResource<MockTexturePtr> history;
+	history.reset(a, b);
+	history.markWritten();
+	history.endFrame();
+	CHECK(history.hasValidHistory());
+
+	history.invalidate();
+	CHECK(!history.hasValidHistory());
+	CHECK(history.getCurrent() == b);
+	CHECK(history.getPrevious() == a);
+
+	MockTexturePtr c = std::make_shared<MockTexture>(), d = std::make_shared<MockTexture>();
+	history.markWritten();
+	history.reset(c, d);
+	CHECK(history.getCurrent() == c && history.getPrevious() == d);
+	CHECK(!history.endFrame());                     // reset() discards a pending write, too
+	CHECK(!history.hasValidHistory());
+}
+
+int main()
+{
+	testSwapsAfterWrite();
+	testUnwrittenFramesDontSwap();
+	testInvalidateAndReset();
+	return TestHarness::result("PingPongResourceTests");
+}
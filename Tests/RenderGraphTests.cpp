@@ -0,0 +1,171 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "RenderGraph.h"
+#include "TestHarness.h"
+#include <algorithm>
+
+namespace {
+	const char* kOutput = "PipelineOutput";
+
+	bool hasEdge(const std::vector<uint32_t>& edges, uint32_t passIdx)
+	{
+		return std::find(edges.begin(), edges.end(), passIdx) != edges.end();
+	}
+};
+
+// A G-buffer feeding two shading passes, only one of which reaches the output
+void testCullsPassesThatDontReachOutput()
+{
+	RenderGraph graph;
+	uint32_t gbuf = graph.addPass("G-Buffer", {}, { "WorldPosition", "WorldNormal" });
+	uint32_t ao   = graph.addPass("AO", { "WorldPosition", "WorldNormal" }, { "AOOutput" }, { "AOOutput" });
+	uint32_t diff = graph.addPass("Diffuse", { "WorldPosition" }, { "DiffuseOutput" }, { "DiffuseOutput" });
+	uint32_t copy = graph.addPass("Copy", { "AOOutput" }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(!graph.isCulled(gbuf));
+	CHECK(!graph.isCulled(ao));
+	CHECK(graph.isCulled(diff));
+	CHECK(!graph.isCulled(copy));
+	CHECK(graph.getCulledPassCount() == 1);
+	CHECK(graph.getExecutionOrder() == std::vector<uint32_t>({ gbuf, ao, copy }));
+	CHECK(graph.getWarnings().empty());
+}
+
+// A pass that only overwrites some texels must not hide the pass that produced the rest
+void testPartialWriteKeepsUpstreamProducer()
+{
+	RenderGraph graph;
+	uint32_t background = graph.addPass("Background", {}, { kOutput }, { kOutput });
+	uint32_t overlay    = graph.addPass("Overlay", {}, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(!graph.isCulled(background));
+	CHECK(!graph.isCulled(overlay));
+	CHECK(hasEdge(graph.getProducers(overlay), background));
+	CHECK(graph.getExecutionOrder() == std::vector<uint32_t>({ background, overlay }));
+}
+
+// ...whereas a full-coverage write makes any earlier write of the channel dead
+void testFullCoverageWriteCullsEarlierWriter()
+{
+	RenderGraph graph;
+	uint32_t first  = graph.addPass("First", {}, { kOutput }, { kOutput });
+	uint32_t second = graph.addPass("Second", {}, { kOutput }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.isCulled(first));
+	CHECK(!graph.isCulled(second));
+	CHECK(graph.getProducers(second).empty());
+}
+
+// Accumulation reads and writes the same channel, so whoever wrote it first stays live
+void testReadModifyWriteKeepsProducer()
+{
+	RenderGraph graph;
+	uint32_t shade = graph.addPass("Shade", {}, { "Color" }, { "Color" });
+	uint32_t accum = graph.addPass("Accumulate", { "Color" }, { "Color" });
+	uint32_t tone  = graph.addPass("ToneMap", { "Color" }, { kOutput }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.getCulledPassCount() == 0);
+	CHECK(hasEdge(graph.getConsumers(shade), accum));
+	CHECK(hasEdge(graph.getConsumers(accum), tone));
+	CHECK(graph.getExecutionOrder() == std::vector<uint32_t>({ shade, accum, tone }));
+}
+
+// Opaque passes might touch anything, so nothing before them may be culled or reordered past them
+void testOpaquePassIsABarrier()
+{
+	RenderGraph graph;
+	uint32_t unused = graph.addPass("Unused", {}, { "Scratch" }, { "Scratch" });
+	uint32_t opaque = graph.addOpaquePass("Opaque");
+	uint32_t after  = graph.addPass("After", {}, { "Other" }, { "Other" });
+	uint32_t copy   = graph.addPass("Copy", {}, { kOutput }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.hasOpaquePasses());
+	CHECK(graph.isOpaque(opaque));
+	CHECK(!graph.isCulled(unused));
+	CHECK(!graph.isCulled(opaque));
+	CHECK(graph.isCulled(after));
+	CHECK(hasEdge(graph.getProducers(opaque), unused));
+	CHECK(graph.getExecutionOrder() == std::vector<uint32_t>({ unused, opaque, copy }));
+}
+
+// Reading a channel nobody wrote is a warning, unless the channel exists before the pipeline runs
+void testReadBeforeWriteWarnings()
+{
+	RenderGraph graph;
+	graph.addPass("Shade", { "WorldPosition", "EnvironmentMap" }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.getWarnings().size() == 2);
+
+	graph.addExternalChannel("EnvironmentMap");
+	CHECK(!graph.isCompiled());
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.getWarnings().size() == 1);
+}
+
+// If nothing writes the output, culling would remove everything, so compile() keeps every pass
+void testMissingOutputRunsEverything()
+{
+	RenderGraph graph;
+	graph.addPass("A", {}, { "Foo" });
+	graph.addPass("B", { "Foo" }, { "Bar" });
+
+	CHECK(!graph.compile(kOutput));
+	CHECK(graph.isCompiled());
+	CHECK(graph.getCulledPassCount() == 0);
+	CHECK(graph.getExecutionOrder().size() == 2);
+	CHECK(!graph.getWarnings().empty());
+}
+
+// Passes that are independent keep the pipeline's order; a write-after-read keeps the reader first
+void testOrderingEdges()
+{
+	RenderGraph graph;
+	uint32_t write = graph.addPass("Write", {}, { "Temp" }, { "Temp" });
+	uint32_t read  = graph.addPass("Read", { "Temp" }, { "Result" }, { "Result" });
+	uint32_t reuse = graph.addPass("Reuse", { "Result" }, { "Temp" }, { "Temp" });
+	uint32_t copy  = graph.addPass("Copy", { "Temp" }, { kOutput }, { kOutput });
+
+	CHECK(graph.compile(kOutput));
+	CHECK(graph.getCulledPassCount() == 0);
+	CHECK(!hasEdge(graph.getConsumers(read), write));
+	CHECK(graph.getExecutionOrder() == std::vector<uint32_t>({ write, read, reuse, copy }));
+
+	graph.clear();
+	CHECK(graph.getPassCount() == 0);
+	CHECK(!graph.isCompiled());
+}
+
+int main()
+{
+	testCullsPassesThatDontReachOutput();
+	testPartialWriteKeepsUpstreamProducer();
+	testFullCoverageWriteCullsEarlierWriter();
+	testReadModifyWriteKeepsProducer();
+	testOpaquePassIsABarrier();
+	testReadBeforeWriteWarnings();
+	testMissingOutputRunsEverything();
+	testOrderingEdges();
+	return TestHarness::result("RenderGraphTests");
+}
@@ -0,0 +1,156 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "ResourcePool.h"
+#include "TestHarness.h"
+#include <memory>
+
+namespace {
+	struct MockKey
+	{
+		uint32_t format;
+		uint32_t width;
+		uint32_t height;
+		bool operator==(const MockKey& other) const { return format == other.format && width == other.width && height == other.height; }
+	};
+
+	struct MockTexture
+	{
+		MockKey  key;
+		uint32_t serial;
+	};
+	using MockTexturePtr = std::shared_ptr<MockTexture>;
+
+	// Stands in for Texture::create2D(), counting how often the pool hits the "driver"
+	struct MockAllocator
+	{
+		uint32_t allocations = 0;
+		ResourcePool<MockKey, MockTexturePtr>::Allocator get()
+		{
+			return [this](const MockKey& key) { return std::make_shared<MockTexture>(MockTexture{ key, allocations++ }); };
+		}
+	};
+
+	const MockKey kSmall = { 1, 640, 480 };
+	const MockKey kLarge = { 1, 1920, 1080 };
+	const MockKey kOtherFormat = { 2, 640, 480 };
+};
+
+// Released resources come back out for matching keys (most recently released first), and only for matching keys
+void testReuseMatchesKeys()
+{
+	MockAllocator mock;
+	ResourcePool<MockKey, MockTexturePtr> pool(mock.get());
+
+	MockTexturePtr a = pool.acquire(kSmall);
+	MockTexturePtr b = pool.acquire(kSmall);
+	CHECK(mock.allocations == 2);
+
+	pool.release(kSmall, a);
+	pool.release(kSmall, b);
+	CHECK(pool.getPooledCount() == 2);
+
+	CHECK(pool.acquire(kOtherFormat)->serial == 2);   // Different format:  must allocate
+	CHECK(pool.acquire(kSmall) == b);                 // Most recently released first
+	CHECK(pool.acquire(kSmall) == a);
+	CHECK(mock.allocations == 3);
+	CHECK(pool.getStats().allocations == 3);
+	CHECK(pool.getStats().reuses == 2);
+	CHECK(pool.getStats().releases == 2);
+}
+
+// A window drag that goes large and back:  returning to a prior size reuses the prior textures
+void testResizeBurstReusesAllocations()
+{
+	MockAllocator mock;
+	ResourcePool<MockKey, MockTexturePtr> pool(mock.get());
+	const uint32_t kChannels = 6;
+
+	std::vector<MockTexturePtr> channels;
+	for (uint32_t i = 0; i < kChannels; i++) channels.push_back(pool.acquire(kSmall));
+
+	const MockKey sizes[] = { kLarge, kSmall, kLarge, kSmall };
+	MockKey cur = kSmall;
+	for (const MockKey& next : sizes)
+	{
+		for (auto& tex : channels) pool.release(cur, tex);
+		for (auto& tex : channels) tex = pool.acquire(next);
+		cur = next;
+		pool.endFrame();
+	}
+
+	CHECK(mock.allocations == 2 * kChannels);       // One set per distinct size, however many resizes
+	CHECK(pool.getStats().reuses == 3 * kChannels);       // Every resize after the first went to a size seen before
+	for (auto& tex : channels) CHECK(tex->key == kSmall);
+}
+
+// Resources unused for framesToKeep frames are dropped, as are the oldest ones beyond the pool's capacity
+void testEviction()
+{
+	MockAllocator mock;
+	ResourcePool<MockKey, MockTexturePtr> pool(mock.get(), 2, 3);
+
+	MockTexturePtr a = pool.acquire(kSmall);
+	std::weak_ptr<MockTexture> aWeak = a;
+	pool.release(kSmall, a);
+	a = nullptr;
+	pool.endFrame();
+	pool.endFrame();
+	CHECK(pool.getPooledCount() == 1);
+	pool.endFrame();
+	CHECK(pool.getPooledCount() == 0);
+	CHECK(pool.getStats().evictions == 1);
+	CHECK(aWeak.expired());                          // The pool's reference was the last one
+
+	std::vector<MockTexturePtr> textures;
+	for (uint32_t i = 0; i < 4; i++) textures.push_back(pool.acquire(kLarge));
+	for (auto& tex : textures) pool.release(kLarge, tex);
+	CHECK(pool.getPooledCount() == 3);
+	CHECK(pool.getStats().evictions == 2);
+	CHECK(pool.acquire(kLarge) == textures[3]);
+	CHECK(pool.acquire(kLarge) == textures[2]);
+	CHECK(pool.acquire(kLarge) == textures[1]);       // textures[0] was the oldest, so it was evicted
+	CHECK(pool.acquire(kLarge) != textures[0]);
+}
+
+// Null resources are never pooled; clear() and resetStats() start fresh
+void testNullReleaseAndClear()
+{
+	MockAllocator mock;
+	ResourcePool<MockKey, MockTexturePtr> pool(mock.get());
+	pool.release(kSmall, nullptr);
+	CHECK(pool.getPooledCount() == 0);
+	CHECK(pool.getStats().releases == 0);
+
+	pool.release(kSmall, pool.acquire(kSmall));
+	pool.clear();
+	CHECK(pool.getPooledCount() == 0);
+	CHECK(pool.getStats().evictions == 1);
+
+	pool.resetStats();
+	CHECK(pool.getStats().allocations == 0 && pool.getStats().evictions == 0);
+}
+
+int main()
+{
+	testReuseMatchesKeys();
+	testResizeBurstReusesAllocations();
+	testEviction();
+	testNullReleaseAndClear();
+	return TestHarness::result("ResourcePoolTests");
+}
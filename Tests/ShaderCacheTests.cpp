@@ -0,0 +1,242 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "ShaderCache.h"
+#include "TestHarness.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace {
+	// Test files live in the working directory, prefixed so they're easy to spot (and clean up)
+	const char* kCacheDir = "ShaderCacheTests.cache";
+
+	void writeFile(const std::string &path, const std::string &contents)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << contents;
+	}
+
+	bool fileExists(const std::string &path)
+	{
+		std::ifstream file(path);
+		return file.good();
+	}
+
+	// A ray tracing program:  one source including a header, which includes another (plus a compiler-provided header)
+	ShaderCache::ProgramDesc makeDesc()
+	{
+		writeFile("ShaderCacheTests.rt.hlsl", "#include \"ShaderCacheTests.Common.hlsli\"\nvoid RayGen() {}\n");
+		writeFile("ShaderCacheTests.Common.hlsli", "  #  include <ShaderCacheTests.Inner.hlsli>\n#include \"HostDeviceSharedMacros.h\"\n");
+		writeFile("ShaderCacheTests.Inner.hlsli", "static const float kPi = 3.14159f;\n");
+
+		ShaderCache::ProgramDesc desc;
+		desc.addSourceFile("ShaderCacheTests.rt.hlsl");
+		desc.entryPoints = { "RayGen", "Miss" };
+		desc.addDefine("DO_GI", "1");
+		desc.addDefine("MAX_DEPTH", "4");
+		desc.target = "raytracing";
+		return desc;
+	}
+};
+
+void testFindIncludes()
+{
+	auto includes = ShaderCache::findIncludes("#include \"a.hlsli\"\n\t# include <b.h>\n// #include \"c.h\"\n#include \"\"\n#define X\n#include \"d.hlsli\" // comment\n");
+	CHECK(includes.size() == 3);
+	CHECK(includes.size() == 3 && includes[0] == "a.hlsli" && includes[1] == "b.h" && includes[2] == "d.hlsli");
+}
+
+// Keys are stable, and change whenever anything that affects the compiled program does
+void testKeyInvalidation()
+{
+	auto pCache = ShaderCache::create(kCacheDir);
+	ShaderCache::ProgramDesc desc = makeDesc();
+	ShaderCache::Key key = pCache->computeKey(desc);
+	CHECK(key.valid);
+	CHECK(key.dependencies.size() == 3);                    // The source and both (transitively) included files
+	CHECK(key.unresolved.size() == 1 && key.unresolved[0] == "HostDeviceSharedMacros.h");
+	CHECK(pCache->computeKey(desc).hash == key.hash);
+
+	// #define order doesn't matter; values and entry point order do
+	ShaderCache::ProgramDesc reordered = desc;
+	std::swap(reordered.defines[0], reordered.defines[1]);
+	CHECK(pCache->computeKey(reordered).hash == key.hash);
+
+	ShaderCache::ProgramDesc changed = desc;
+	changed.addDefine("MAX_DEPTH", "5");
+	CHECK(pCache->computeKey(changed).hash != key.hash);
+	changed = desc;
+	std::swap(changed.entryPoints[0], changed.entryPoints[1]);
+	CHECK(pCache->computeKey(changed).hash != key.hash);
+	changed = desc;
+	changed.target = "raytracing -O0";
+	CHECK(pCache->computeKey(changed).hash != key.hash);
+
+	// Editing a file two #includes down changes the key...
+	writeFile("ShaderCacheTests.Inner.hlsli", "static const float kPi = 3.14f;\n");
+	uint64_t editedHash = pCache->computeKey(desc).hash;
+	CHECK(editedHash != key.hash);
+
+	// ...and so does a header appearing where an unresolved #include can now find it
+	writeFile("HostDeviceSharedMacros.h", "#define HOST_CODE 0\n");
+	ShaderCache::Key resolvedKey = pCache->computeKey(desc);
+	CHECK(resolvedKey.hash != editedHash && resolvedKey.unresolved.empty());
+	std::remove("HostDeviceSharedMacros.h");
+
+	// Missing sources make the key invalid (and so uncacheable)
+	changed = desc;
+	changed.addSourceFile("ShaderCacheTests.Missing.hlsl");
+	CHECK(!pCache->computeKey(changed).valid);
+}
+
+// Sources not found as given are searched for in the include directories
+void testIncludeDirectories()
+{
+	auto pCache = ShaderCache::create(kCacheDir, { "." });
+	ShaderCache::ProgramDesc desc = makeDesc();
+	desc.sourceFiles = { "ShaderCacheTests.rt.hlsl" };
+	CHECK(pCache->computeKey(desc).valid);
+
+	auto pNoDirs = ShaderCache::create(kCacheDir, { "NoSuchDirectory" });
+	writeFile("ShaderCacheTests.Local.hlsl", "#include \"ShaderCacheTests.Inner.hlsli\"\n");
+	desc.sourceFiles = { "ShaderCacheTests.Local.hlsl" };
+	ShaderCache::Key key = pNoDirs->computeKey(desc);
+	CHECK(key.valid && key.dependencies.size() == 2);        // Includes relative to the including file are always found
+}
+
+void testEntryFormat()
+{
+	std::vector<uint8_t> blob = { 1, 2, 3, 4, 5, 6, 7 };
+	std::vector<uint8_t> entry = ShaderCache::serializeEntry(0x1234u, blob);
+	std::vector<uint8_t> out;
+	CHECK(ShaderCache::deserializeEntry(entry, 0x1234u, out) && out == blob);
+	CHECK(!ShaderCache::deserializeEntry(entry, 0x1235u, out));            // Someone else's entry
+
+	std::vector<uint8_t> truncated(entry.begin(), entry.end() - 1);
+	CHECK(!ShaderCache::deserializeEntry(truncated, 0x1234u, out));
+	CHECK(!ShaderCache::deserializeEntry(std::vector<uint8_t>(entry.begin(), entry.begin() + 10), 0x1234u, out));
+
+	std::vector<uint8_t> corrupt = entry;
+	corrupt.back() ^= 0xffu;
+	CHECK(!ShaderCache::deserializeEntry(corrupt, 0x1234u, out));
+
+	std::vector<uint8_t> badMagic = entry;
+	badMagic[0] ^= 0xffu;
+	CHECK(!ShaderCache::deserializeEntry(badMagic, 0x1234u, out));
+
+	std::vector<uint8_t> oldVersion = entry;
+	oldVersion[4] = uint8_t(ShaderCache::kFormatVersion + 1);
+	CHECK(!ShaderCache::deserializeEntry(oldVersion, 0x1234u, out));
+
+	std::vector<uint8_t> empty;
+	CHECK(ShaderCache::deserializeEntry(ShaderCache::serializeEntry(7u, empty), 7u, out) && out.empty());
+}
+
+void testStoreAndLoad()
+{
+	auto pCache = ShaderCache::create(kCacheDir);
+	pCache->clear();
+	ShaderCache::Key key = pCache->computeKey(makeDesc());
+
+	std::vector<uint8_t> blob;
+	CHECK(!pCache->load(key, blob));
+	std::vector<uint8_t> stored = { 9, 8, 7 };
+	CHECK(pCache->store(key, stored));
+	CHECK(pCache->load(key, blob) && blob == stored);
+
+	// A new cache over the same directory (i.e., the next run) sees the entry; overwriting it works too
+	auto pNextRun = ShaderCache::create(kCacheDir);
+	CHECK(pNextRun->load(key, blob) && blob == stored);
+	stored.push_back(6);
+	CHECK(pNextRun->store(key, stored));
+	CHECK(pNextRun->load(key, blob) && blob == stored);
+
+	// Invalid keys are never stored or found
+	ShaderCache::Key invalid;
+	CHECK(!pCache->store(invalid, stored) && !pCache->load(invalid, blob));
+
+	ShaderCache::Stats stats = pCache->getStats();
+	CHECK(stats.hits == 1 && stats.misses == 1 && stats.stores == 1 && stats.rejected == 0);
+
+	pCache->clear();
+	CHECK(!fileExists(pCache->getEntryPath(key)));
+	CHECK(!pCache->load(key, blob));
+}
+
+// Corrupt entries are treated as misses, and deleted so they don't cost a read every run
+void testCorruptEntryRejected()
+{
+	auto pCache = ShaderCache::create(kCacheDir);
+	ShaderCache::Key key = pCache->computeKey(makeDesc());
+	CHECK(pCache->store(key, { 1, 2, 3, 4 }));
+
+	std::string path = pCache->getEntryPath(key);
+	std::vector<uint8_t> entry = ShaderCache::serializeEntry(key.hash, { 1, 2, 3, 4 });
+	writeFile(path, std::string(entry.begin(), entry.end() - 2));     // A torn write
+
+	std::vector<uint8_t> blob;
+	CHECK(!pCache->load(key, blob));
+	CHECK(pCache->getStats().rejected == 1);
+	CHECK(!fileExists(path));
+}
+
+// Launches on different threads share a cache
+void testConcurrentUse()
+{
+	auto pCache = ShaderCache::create(kCacheDir);
+	pCache->clear();
+	ShaderCache::Key key = pCache->computeKey(makeDesc());
+	const std::vector<uint8_t> stored(4096, 0x5au);
+
+	const uint32_t kThreads = 4, kIterations = 50;
+	std::vector<std::thread> threads;
+	std::vector<uint32_t> badLoads(kThreads, 0);
+	for (uint32_t t = 0; t < kThreads; t++)
+	{
+		threads.push_back(std::thread([&, t]() {
+			for (uint32_t i = 0; i < kIterations; i++)
+			{
+				pCache->store(key, stored);
+				std::vector<uint8_t> blob;
+				if (pCache->load(key, blob) && blob != stored) badLoads[t]++;
+			}
+		}));
+	}
+	for (auto &thread : threads) thread.join();
+
+	for (uint32_t bad : badLoads) CHECK(bad == 0);     // Never a partial entry
+	ShaderCache::Stats stats = pCache->getStats();
+	CHECK(stats.hits + stats.misses == kThreads * kIterations);
+	pCache->clear();
+}
+
+int main()
+{
+	testFindIncludes();
+	testKeyInvalidation();
+	testIncludeDirectories();
+	testEntryFormat();
+	testStoreAndLoad();
+	testCorruptEntryRejected();
+	testConcurrentUse();
+
+	for (auto file : { "ShaderCacheTests.rt.hlsl", "ShaderCacheTests.Common.hlsli", "ShaderCacheTests.Inner.hlsli", "ShaderCacheTests.Local.hlsl" })
+		std::remove(file);
+	return TestHarness::result("ShaderCacheTests");
+}
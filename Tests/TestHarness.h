@@ -0,0 +1,44 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#pragma once
+#include <cstdio>
+
+/** A minimal checking harness for the SharedUtils tests.  Each test executable calls its test functions 
+    from main(), which returns TestHarness::result() so CTest sees any failed CHECK().
+*/
+namespace TestHarness
+{
+	inline int& failureCount() { static int count = 0; return count; }
+
+	inline int result(const char* testName)
+	{
+		if (failureCount() == 0) std::printf("%s: all checks passed\n", testName);
+		else std::printf("%s: %d check(s) failed\n", testName, failureCount());
+		return failureCount() == 0 ? 0 : 1;
+	}
+};
+
+#define CHECK(cond)                                                                              \
+	do {                                                                                         \
+		if (!(cond))                                                                             \
+		{                                                                                        \
+			std::printf("%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #cond);                \
+			TestHarness::failureCount()++;                                                       \
+		}                                                                                        \
+	} while (0)
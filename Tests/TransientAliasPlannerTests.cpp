@@ -0,0 +1,145 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "TransientAliasPlanner.h"
+#include "TestHarness.h"
+
+namespace {
+	TransientAliasPlanner::AliasKey makeKey(uint32_t format, int32_t width = -1, int32_t height = -1)
+	{
+		TransientAliasPlanner::AliasKey key;
+		key.format = format;
+		key.bindFlags = 1;
+		key.width = width;
+		key.height = height;
+		return key;
+	}
+
+	const uint64_t kSize = 1024;
+};
+
+// A -> B -> C chain:  A is dead once B is written, so C can reuse A's memory
+void testDisjointLifetimesShareMemory()
+{
+	TransientAliasPlanner planner;
+	uint32_t a = planner.addResource("A", makeKey(1), kSize);
+	uint32_t b = planner.addResource("B", makeKey(1), kSize);
+	uint32_t c = planner.addResource("C", makeKey(1), kSize);
+	planner.addUse("A", 0, true);
+	planner.addUse("A", 1, false);
+	planner.addUse("B", 1, true);
+	planner.addUse("B", 2, false);
+	planner.addUse("C", 2, true);
+	planner.addUse("C", 3, false);
+
+	CHECK(planner.plan() == 2);
+	CHECK(planner.getAliasTarget(a) == a);
+	CHECK(planner.getAliasTarget(b) == b);
+	CHECK(planner.getAliasTarget(c) == a);
+	CHECK(planner.getUnaliasedBytes() == 3 * kSize);
+	CHECK(planner.getAliasedBytes() == 2 * kSize);
+	CHECK(planner.getBytesSaved() == kSize);
+}
+
+// A pass reading one resource while writing another needs both at once, as do resources with different keys
+void testOverlapsAndMismatchedKeysDontShare()
+{
+	TransientAliasPlanner planner;
+	uint32_t a = planner.addResource("A", makeKey(1), kSize);
+	uint32_t b = planner.addResource("B", makeKey(1), kSize);
+	uint32_t c = planner.addResource("C", makeKey(2), kSize);
+	uint32_t d = planner.addResource("D", makeKey(1, 64, 64), kSize);
+	planner.addUse("A", 0, true);
+	planner.addUse("A", 1, false);
+	planner.addUse("B", 1, true);
+	planner.addUse("C", 2, true);
+	planner.addUse("D", 3, true);
+
+	CHECK(planner.plan() == 4);
+	CHECK(planner.getAliasTarget(a) == a);
+	CHECK(planner.getAliasTarget(b) == b);
+	CHECK(planner.getAliasTarget(c) == c);
+	CHECK(planner.getAliasTarget(d) == d);
+	CHECK(planner.getBytesSaved() == 0);
+}
+
+// Pinned resources, and resources read before they're written (history), keep their memory to themselves
+void testPinnedAndHistoryResourcesAreNotAliased()
+{
+	TransientAliasPlanner planner;
+	uint32_t output  = planner.addResource("Output", makeKey(1), kSize, true);
+	uint32_t history = planner.addResource("History", makeKey(1), kSize);
+	uint32_t temp    = planner.addResource("Temp", makeKey(1), kSize);
+	planner.addUse("History", 0, false);
+	planner.addUse("History", 0, true);
+	planner.addUse("Output", 1, true);
+	planner.addUse("Temp", 2, true);
+
+	CHECK(planner.plan() == 3);
+	CHECK(planner.isPinned(output));
+	CHECK(planner.isPinned(history));
+	CHECK(!planner.isPinned(temp));
+	CHECK(planner.getAliasTarget(temp) == temp);
+}
+
+// Resources no pass touches this frame may hold persistent data, so they live all frame:  they must neither 
+//    borrow another resource's memory nor lend theirs
+void testUnusedResourcesLiveAllFrame()
+{
+	TransientAliasPlanner planner;
+	uint32_t a      = planner.addResource("A", makeKey(1), kSize);
+	uint32_t unused = planner.addResource("Unused", makeKey(1), kSize);
+	uint32_t b      = planner.addResource("B", makeKey(1), kSize);
+	planner.addUse("A", 0, true);
+	planner.addUse("A", 1, false);
+	planner.addUse("B", 2, true);
+
+	CHECK(planner.plan() == 2);
+	CHECK(!planner.isUsed(unused));
+	CHECK(planner.isPinned(unused));
+	CHECK(planner.getAliasTarget(unused) == unused);
+	CHECK(planner.getAliasTarget(b) == a);
+	CHECK(planner.getAliasTarget(a) == a);
+}
+
+// Unknown names are ignored; clear() forgets everything
+void testUnknownNamesAndClear()
+{
+	TransientAliasPlanner planner;
+	planner.addResource("A", makeKey(1), kSize);
+	planner.addUse("NotAResource", 0, true);
+	planner.addUse("A", 0, true);
+
+	CHECK(planner.plan() == 1);
+	CHECK(planner.getResourceCount() == 1);
+	CHECK(planner.getName(0) == "A");
+
+	planner.clear();
+	CHECK(planner.getResourceCount() == 0);
+	CHECK(planner.plan() == 0);
+}
+
+int main()
+{
+	testDisjointLifetimesShareMemory();
+	testOverlapsAndMismatchedKeysDontShare();
+	testPinnedAndHistoryResourcesAreNotAliased();
+	testUnusedResourcesLiveAllFrame();
+	testUnknownNamesAndClear();
+	return TestHarness::result("TransientAliasPlannerTests");
+}
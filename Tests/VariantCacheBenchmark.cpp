@@ -0,0 +1,106 @@
+/**********************************************************************************************************************
+# Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+# following conditions are met:
+#  * Redistributions of code must retain the copyright notice, this list of conditions and the following disclaimer.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its contributors may be used to endorse or promote products
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+# OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************************************************/
+
+#include "LruCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/** RayLaunch keeps recently used program variants (one per set of #defines) in an LruCache, so toggling a pass'
+    options back doesn't recompile.  This measures the CPU cost of a toggle's lookup (building the define key, as
+    RayLaunch::getDefineKey() does, then finding it), and how often each cache capacity avoids a recompile for
+    the ways people use GGXGlobalIlluminationPass' two toggles.  Pass a toggle count to run longer.
+*/
+
+namespace {
+	using Defines = std::vector<std::pair<std::string, std::string>>;
+
+	// As RayLaunch::getDefineKey()
+	std::string getDefineKey(Defines defines)
+	{
+		std::sort(defines.begin(), defines.end());
+		std::string key;
+		for (auto &define : defines)
+			key += define.first + "=" + define.second + "\n";
+		return key;
+	}
+
+	Defines makeDefines(bool doDirect, bool doIndirect)
+	{
+		return { { "DO_DIRECT_GI", doDirect ? "1" : "0" }, { "DO_INDIRECT_GI", doIndirect ? "1" : "0" } };
+	}
+
+	// Replays a sequence of variants (each 0..3, i.e., the two toggles' bits) through a cache; returns the hit rate
+	double hitRate(size_t capacity, const std::vector<uint32_t>& variants)
+	{
+		LruCache<std::string, uint32_t> cache(capacity);
+		for (uint32_t variant : variants)
+		{
+			std::string key = getDefineKey(makeDefines((variant & 1u) != 0, (variant & 2u) != 0));
+			if (!cache.find(key)) cache.insert(key, variant);
+		}
+		return double(cache.getStats().hits) / double(variants.size());
+	}
+};
+
+int main(int argc, char** argv)
+{
+	uint32_t toggles = (argc > 1) ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 100000u;
+	if (toggles < 4) toggles = 4;
+
+	// How people flip the toggles:  one back and forth, cycling through every combination, or at random
+	std::vector<uint32_t> flipOne, cycleAll, random;
+	std::mt19937 rng(1234u);
+	for (uint32_t i = 0; i < toggles; i++)
+	{
+		flipOne.push_back(i & 1u);
+		cycleAll.push_back(i & 3u);
+		random.push_back(rng() & 3u);
+	}
+
+	// Capacity 4 holds all four variants, so after the first four builds every toggle should hit
+	if (hitRate(4, cycleAll) != double(toggles - 4) / double(toggles))
+	{
+		std::printf("VariantCacheBenchmark: unexpected LRU behavior\n");
+		return 1;
+	}
+
+	// The per-toggle lookup, with a warm cache
+	LruCache<std::string, uint32_t> cache(4);
+	volatile uint32_t sink = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t i = 0; i < toggles; i++)
+	{
+		std::string key = getDefineKey(makeDefines((random[i] & 1u) != 0, (random[i] & 2u) != 0));
+		if (uint32_t* pVariant = cache.find(key)) sink = sink + *pVariant;
+		else cache.insert(key, random[i]);
+	}
+	double lookupNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / toggles;
+
+	std::printf("VariantCacheBenchmark (%u toggles of two #define toggles)\n", toggles);
+	std::printf("  Lookup (define key + find):  %.1f ns/toggle\n", lookupNs);
+	std::printf("  Recompiles avoided:      flip one   cycle all   random\n");
+	for (size_t capacity : { 1, 2, 3, 4, 8 })
+		std::printf("    capacity %zu:            %6.1f%%     %6.1f%%   %6.1f%%\n", capacity,
+			100.0 * hitRate(capacity, flipOne), 100.0 * hitRate(capacity, cycleAll), 100.0 * hitRate(capacity, random));
+	return 0;
+}